@@ -0,0 +1,127 @@
+/**
+* @file     : board_detector.h
+* @brief    : vision detections of get_board_position -> stable mission num and board positions.
+*             board positions are mapped in every flight phase(background mapping), a detection counting
+*             by the confidence of the phase it was made in(camera_switch), scanning counting most.
+*             positions are estimated per board(BoardEstimate) and published with their std dev.
+*             boards are kept in a BoardMap: any number of boards, ids 0..BOARD_ID_MAX.
+*             the mission num is voted(DigitVoter) while reading it, the votes restart on leaving.
+*             published boards change only when moved by BOARD_PUBLISH_EPSILON, each change counted in its
+*             version, changes sent as BoardMapDelta(sequence numbered, periodic keyframes).
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_BOARD_DETECTOR_H
+#define STATE_MACHINE_BOARD_DETECTOR_H
+
+#include <sensor_msgs/LaserScan.h>
+#include <state_machine/DrawingBoard10.h>
+#include <state_machine/BoardDetections.h>
+#include <state_machine/BoardMapDelta.h>
+#include <geometry_msgs/Point.h>
+#include <state_machine/board_estimator.h>
+#include <state_machine/board_map.h>
+#include <state_machine/detection_batch.h>
+#include <state_machine/digit_voter.h>
+
+/* confidence of a detection per phase: its variance is divided by the weight. */
+#define BOARD_MAPPING_WEIGHT_SCAN 1.0       /* camera_switch 2: vision_num_scan. */
+#define BOARD_MAPPING_WEIGHT_NUM 0.75       /* camera_switch 1: hovering in front of the boards, reading num. */
+#define BOARD_MAPPING_WEIGHT_TRANSIT 0.5    /* camera_switch 0: takeoff, moves and return(motion blur, far). */
+
+struct BoardMappingConfig
+{
+    bool background;        /* false: positions only while scanning(camera_switch 2). */
+    double weight[3];       /* by camera_switch. */
+};
+
+BoardMappingConfig board_mapping_default_config();
+
+/* result of BoardDetector::update. */
+static const unsigned BOARD_NUM_UPDATED = 1;        /* num decided by the voter: publish num(), voter(). */
+static const unsigned BOARD_POSITION_UPDATED = 2;   /* published boards changed since the last delta(): publish boards(), delta(). */
+
+/* num of a detection(BoardDetections): 0..BOARD_ID_MAX board id, BOARD_NUM_INCOMPLETE ends the detections,
+ * < 0: num not read, associated with the nearest board within BOARD_ASSOCIATION_RADIUS.
+ * vision_num_scan(LaserScan): 0..BOARD_SCAN_NUM_MAX only, anything else ends the detections. */
+#define BOARD_ID_MAX 65535
+#define BOARD_SCAN_NUM_MAX 9
+#define BOARD_NUM_INCOMPLETE 11         /* incomplete rectangle detected. */
+#define BOARD_ASSOCIATION_RADIUS 0.5    /* m */
+#define BOARD_PUBLISH_EPSILON 0.01      /* m: smaller changes of position or std dev are not published. */
+
+/* BoardDetection fixed point. */
+#define BOARD_DETECTION_POSITION_SCALE 0.001        /* mm -> m */
+#define BOARD_DETECTION_SIGMA_SCALE 0.01            /* cm -> m */
+#define BOARD_DETECTION_CONFIDENCE_SCALE (1.0/255)
+
+class BoardDetector
+{
+public:
+    BoardDetector();
+
+    /* board_mapping_default_config() unless set. */
+    void set_mapping(const BoardMappingConfig& mapping) { mapping_ = mapping; }
+
+    /* board_estimator_default_config() unless set. */
+    void set_estimator(const BoardEstimatorConfig& estimator) { estimator_ = estimator; }
+
+    /* digit_voter_default_config() unless set. */
+    void set_voter(const DigitVoterConfig& voter) { voter_config_ = voter; }
+
+    /* vision message(/vision/digit_nws_position): ranges = {num, x, y, z} per detection,
+     * x/y/z relative to current_pos. camera_switch: 0: mission closed; 1: vision_one_num_get;
+     * 2: vision_num_scan. positions are mapped in any phase with a weight > 0. */
+    unsigned update(int camera_switch, const sensor_msgs::LaserScan& scan, const geometry_msgs::Point& current_pos);
+
+    /* typed vision message(/vision/board_detections): read in place, no sentinels. a detection's
+     * confidence scales the phase weight, its sigma(if any) replaces the range model. */
+    unsigned update(int camera_switch, const state_machine::BoardDetections& msg, const geometry_msgs::Point& current_pos);
+
+    int num() const { return vision_num_; }
+
+    /* votes of the board in front of the camera: confidence and votes of num() when decided. */
+    const DigitVoter& voter() const { return voter_; }
+
+    /* confidence of a detection made with camera_switch, 0: ignored. */
+    double mapping_weight(int camera_switch) const;
+
+    /* usable board positions(std dev below sigma_usable), sigma: their std dev.
+     * one entry per board in the order they became usable, num: board id. */
+    const state_machine::DrawingBoard10& boards() const { return board10_pub_; }
+
+    /* boards changed since the last delta(all of them on a keyframe) -> msg, next sequence number.
+     * msg.boards keeps its capacity: no allocation once the map is built. */
+    void delta(state_machine::BoardMapDelta& msg, bool keyframe);
+
+    const BoardMap& map() const { return map_; }
+
+private:
+    void num_update(int num);
+    void num_votes_restart(int camera_switch);
+    void scan_update(const sensor_msgs::LaserScan& scan, const geometry_msgs::Point& current_pos, double weight);
+    /* batch_ -> board estimates: transform and gating by the kernel, then per detection. */
+    void ingest(const geometry_msgs::Point& current_pos);
+    void publish(int index);
+
+    BoardMappingConfig mapping_;
+    BoardEstimatorConfig estimator_;
+
+    BoardMap map_;
+    DetectionBatch batch_;
+    std::vector<int> batch_mark_;                   /* landmark -> last batch_serial_ it was fused in. */
+    int batch_serial_;
+    std::vector<int> published_;                    /* landmark -> entry of board10_pub_, -1: not usable yet. */
+    state_machine::DrawingBoard10 board10_pub_;     /* board10 for publish */
+    std::vector<int> dirty_;                        /* entries of board10_pub_ changed since the last delta. */
+    std::vector<bool> dirty_mark_;                  /* entry in dirty_. */
+    uint32_t delta_seq_;
+
+    DigitVoterConfig voter_config_;
+    DigitVoter voter_;
+    int vision_num_;
+    bool num_updated_;
+};
+
+#endif
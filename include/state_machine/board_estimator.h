@@ -0,0 +1,76 @@
+/**
+* @file     : board_estimator.h
+* @brief    : recursive board position estimator: per-board Kalman filter(constant position, diagonal
+*             covariance), detections weighted by range and mapping phase, Mahalanobis outlier gating.
+*             a board is usable as soon as its position std dev is small enough, instead of after
+*             MIN_DETECTION_TIMES consecutive detections.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_BOARD_ESTIMATOR_H
+#define STATE_MACHINE_BOARD_ESTIMATOR_H
+
+#define BOARD_SIGMA_MEASUREMENT 0.15    /* std dev of a scan detection at BOARD_RANGE_NOMINAL(m). */
+#define BOARD_RANGE_NOMINAL 4.0         /* SCAN_VISION_DISTANCE(m). */
+#define BOARD_SIGMA_PROCESS 0.01        /* drift per detection(m): later detections keep a weight. */
+#define BOARD_SIGMA_USABLE 0.08         /* published once the position std dev is below(m). */
+#define BOARD_GATE 11.34                /* Mahalanobis distance^2 gate: chi-square 3 dof, 99%. */
+#define BOARD_REJECT_RESET 3            /* consecutive outliers: estimate restarted from them. */
+
+struct BoardEstimatorConfig
+{
+    double sigma_measurement;
+    double range_nominal;
+    double sigma_process;
+    double sigma_usable;
+    double gate;
+    int reject_reset;
+};
+
+BoardEstimatorConfig board_estimator_default_config();
+
+enum BoardEstimateResult
+{
+    BOARD_ESTIMATE_INIT = 0,    /* first detection. */
+    BOARD_ESTIMATE_UPDATED,
+    BOARD_ESTIMATE_REJECTED,    /* outside the gate. */
+    BOARD_ESTIMATE_RESET,       /* reject_reset outliers in a row: restarted. */
+};
+
+/* plain data: one per board. */
+struct BoardEstimate
+{
+    bool initialized;
+    double x[3];            /* position(m). */
+    double var[3];          /* variance per axis(m^2). */
+    int updates;            /* detections fused. */
+    int rejected;           /* consecutive outliers. */
+    int outliers;           /* outliers in total. */
+};
+
+void board_estimate_reset(BoardEstimate& estimate);
+
+/* variance of a detection(m^2) at range from the camera(m), weight: confidence(0~1]. */
+double board_measurement_var(const BoardEstimatorConfig& config, double range, double weight);
+
+/* detection z(m) with variance r per axis(m^2). */
+BoardEstimateResult board_estimate_fuse(BoardEstimate& estimate, const BoardEstimatorConfig& config,
+                                        const double z[3], const double r[3]);
+
+/* detection z(m) with variance r(m^2), innovation already computed(batch gating): predicted variance
+ * var(m^2), gain k and Mahalanobis distance^2 d2. */
+BoardEstimateResult board_estimate_apply(BoardEstimate& estimate, const BoardEstimatorConfig& config,
+                                         const double z[3], const double r[3],
+                                         const double var[3], const double k[3], double d2);
+
+/* detection z(m), range from the camera(m) and confidence of the mapping phase(0~1]. */
+BoardEstimateResult board_estimate_update(BoardEstimate& estimate, const BoardEstimatorConfig& config,
+                                          const double z[3], double range, double weight);
+
+/* std dev of the worst axis(m), < 0: not initialized. */
+double board_estimate_sigma(const BoardEstimate& estimate);
+
+bool board_estimate_usable(const BoardEstimate& estimate, const BoardEstimatorConfig& config);
+
+#endif
@@ -0,0 +1,61 @@
+/**
+* @file     : board_map.h
+* @brief    : board map: landmarks with arbitrary ids, found by id in O(log n) and by position through
+*             a uniform grid(nearest board, association of detections whose num was not read).
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_BOARD_MAP_H
+#define STATE_MACHINE_BOARD_MAP_H
+
+#include <state_machine/board_estimator.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#define BOARD_MAP_CELL 1.0      /* grid cell(m), about the board spacing. */
+
+struct BoardLandmark
+{
+    int id;                 /* board num. */
+    BoardEstimate estimate;
+    long long cell;         /* grid cell of the estimate. */
+};
+
+class BoardMap
+{
+public:
+    explicit BoardMap(double cell = BOARD_MAP_CELL);
+
+    void clear(void);
+
+    int size() const { return (int)landmarks_.size(); }
+
+    /* index of board id, -1: not mapped. */
+    int find(int id) const;
+
+    /* index of board id, added(not initialized) if not mapped. */
+    int insert(int id);
+
+    const BoardLandmark& landmark(int index) const { return landmarks_[index]; }
+
+    /* estimate of a landmark, moved() MUST be called after changing it. */
+    BoardEstimate& estimate(int index) { return landmarks_[index].estimate; }
+    void moved(int index);
+
+    /* initialized landmark nearest to (x, y) within max_distance(m), -1: none. */
+    int nearest(double x, double y, double max_distance) const;
+
+private:
+    long long key(int cx, int cy) const;
+    int cell_of(double v) const;
+
+    double cell_;
+    std::vector<BoardLandmark> landmarks_;
+    std::map<int, int> index_;                              /* id -> landmark. */
+    std::unordered_map<long long, std::vector<int> > grid_; /* cell -> landmarks. */
+};
+
+#endif
@@ -0,0 +1,36 @@
+/**
+* @file     : board_mirror.h
+* @brief    : consumer side of BoardMapDelta: boards 0..BOARD_NUM_MAX-1 of the mission kept from the deltas
+*             of get_board_position. an entry is applied only if its version changed, the boards changed
+*             are returned(bit num): nothing is copied while the map is stable. after a sequence gap
+*             (message lost) or a publisher restart the versions held are forgotten: every entry is
+*             applied again, the next keyframe brings back every board, and the epoch changes so that
+*             the copy of the mission is taken again in full.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_BOARD_MIRROR_H
+#define STATE_MACHINE_BOARD_MIRROR_H
+
+#include <state_machine/mission.h>
+#include <state_machine/BoardMapDelta.h>
+
+/* plain data. */
+struct BoardMirror
+{
+    uint32_t seq;           /* last message applied. */
+    unsigned lost;          /* messages lost(sequence gaps). */
+    BoardSnapshots boards;  /* version: of the entry applied, 0: none. */
+};
+
+void board_mirror_reset(BoardMirror& mirror);
+
+/* returns the boards changed by msg(bit num). a keyframe also drops the boards it does not hold. */
+unsigned board_mirror_apply(BoardMirror& mirror, const state_machine::BoardMapDelta& msg);
+
+/* boards whose version differs from board(or not versioned) -> board, the others untouched. every
+ * board if epoch(of the last copy, updated) is not the epoch of boards. returns the boards copied(bit num). */
+unsigned board_mirror_copy(const BoardSnapshots& boards, BoardSnapshot* board, uint32_t& epoch);
+
+#endif
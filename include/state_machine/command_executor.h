@@ -0,0 +1,153 @@
+/**
+* @file     : command_executor.h
+* @brief    : mavros service calls(set_mode, arming, land) on a worker thread: the control loop
+*             submits a command and polls its future, setpoint streaming never waits for mavros.
+*             failed calls are retried until the command timeout, round-trip latency is recorded
+*             per service.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_COMMAND_EXECUTOR_H
+#define STATE_MACHINE_COMMAND_EXECUTOR_H
+
+#include <ros/ros.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum CommandStatus
+{
+    COMMAND_SUCCESS = 0,
+    COMMAND_REJECTED,       /* service answered, response.success false on the last attempt. */
+    COMMAND_UNAVAILABLE,    /* service not advertised or call failed on the last attempt. */
+    COMMAND_TIMEOUT,        /* command timeout reached before an attempt succeeded. */
+    COMMAND_DROPPED,        /* executor stopped before the command was run. */
+};
+
+struct CommandResult
+{
+    CommandStatus status;
+    int attempts;
+    double latency;         /* submit -> result(s), queueing and retries included. */
+};
+
+struct CommandOptions
+{
+    int max_attempts;
+    double timeout;         /* whole command, from submit(s). */
+    double retry_delay;     /* between attempts(s). */
+};
+
+/* 3 attempts, 0.5s apart, within 2s. */
+CommandOptions command_default_options();
+
+/* service round trip of single calls, not of whole commands. */
+struct CommandMetrics
+{
+    unsigned calls;
+    unsigned successes;
+    unsigned rejected;
+    unsigned unavailable;
+    unsigned timeouts;      /* commands, not calls. */
+    double rtt_last;        /* s */
+    double rtt_max;
+    double rtt_total;
+};
+
+const char* command_status_name(CommandStatus status);
+
+/* true once the command behind future has finished: never blocks. */
+inline bool command_ready(const std::future<CommandResult>& result)
+{
+    return result.valid() && result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/* true while a submitted command has not finished yet. */
+inline bool command_pending(const std::future<CommandResult>& result)
+{
+    return result.valid() && !command_ready(result);
+}
+
+class CommandExecutor
+{
+public:
+    CommandExecutor();
+    ~CommandExecutor();     /* stop(). */
+
+    /* commands are run one at a time in submit order(e.g. OFFBOARD before arming).
+     * Service: CommandBool, SetMode, CommandTOL(any service with a bool response.success).
+     * name: metrics key, normally the service name. */
+    template <typename Service>
+    std::future<CommandResult> submit(const std::string& name, ros::ServiceClient& client,
+                                      const Service& srv, const CommandOptions& options);
+
+    /* finish the command being called, drop queued ones(COMMAND_DROPPED). */
+    void stop();
+
+    CommandMetrics metrics(const std::string& name) const;
+
+    /* ROS_INFO one line per service. */
+    void report() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    enum CallStatus
+    {
+        CALL_SUCCESS,
+        CALL_REJECTED,
+        CALL_FAILED,
+    };
+
+    struct Command
+    {
+        std::string name;
+        ros::ServiceClient client;
+        std::function<CallStatus()> call;
+        CommandOptions options;
+        Clock::time_point submitted;
+        std::promise<CommandResult> result;
+    };
+
+    std::future<CommandResult> push(const std::string& name, const ros::ServiceClient& client,
+                                    const std::function<CallStatus()>& call, const CommandOptions& options);
+    void run();
+    CommandResult execute(Command& command);
+    void record(const std::string& name, CallStatus status, double rtt);
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::deque<std::unique_ptr<Command> > queue_;
+    std::map<std::string, CommandMetrics> metrics_;
+    bool stopping_;
+    std::thread worker_;
+};
+
+template <typename Service>
+std::future<CommandResult> CommandExecutor::submit(const std::string& name, ros::ServiceClient& client,
+                                                   const Service& srv, const CommandOptions& options)
+{
+    /* request copied: the caller may reuse its service object at once. */
+    ros::ServiceClient service_client = client;
+    Service service = srv;
+    std::function<CallStatus()> call = [service_client, service]() mutable -> CallStatus
+    {
+        if(!service_client.call(service))
+        {
+            return CALL_FAILED;
+        }
+        return service.response.success ? CALL_SUCCESS : CALL_REJECTED;
+    };
+    return push(name, client, call, options);
+}
+
+#endif
@@ -0,0 +1,67 @@
+/**
+* @file     : detection_batch.h
+* @brief    : batch ingest kernel of BoardDetector: the detections of one frame are kept as structure of
+*             arrays, transformed to the local frame, given their measurement variance and gated against
+*             the board estimates lane by lane(AVX with -DBOARD_INGEST_AVX=ON, SSE2, scalar otherwise).
+*             map lookup and the estimate update stay per detection.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_DETECTION_BATCH_H
+#define STATE_MACHINE_DETECTION_BATCH_H
+
+#define DETECTION_BATCH_MAX 64  /* detections per batch, a larger frame is ingested in batches. */
+
+/* structure of arrays, axis-major: d[axis][detection]. */
+struct DetectionBatch
+{
+    int count;
+    int id[DETECTION_BATCH_MAX];            /* board num, < 0: not read. */
+    int landmark[DETECTION_BATCH_MAX];      /* BoardMap index, < 0: not fused in the batch. */
+    alignas(32) double d[3][DETECTION_BATCH_MAX];   /* relative to the vehicle(m). */
+    alignas(32) double w[DETECTION_BATCH_MAX];      /* confidence(0~1]. */
+    alignas(32) double r[3][DETECTION_BATCH_MAX];   /* variance(m^2), < 0 on push: range model. */
+    alignas(32) double z[3][DETECTION_BATCH_MAX];   /* local position(m). */
+    alignas(32) double x[3][DETECTION_BATCH_MAX];   /* estimate gathered before gating. */
+    alignas(32) double var[3][DETECTION_BATCH_MAX]; /* its variance, predicted by detection_batch_gate(). */
+    alignas(32) double k[3][DETECTION_BATCH_MAX];   /* gain. */
+    alignas(32) double d2[DETECTION_BATCH_MAX];     /* Mahalanobis distance^2. */
+};
+
+/* "avx", "sse2" or "scalar". */
+const char* detection_batch_isa(void);
+
+inline void detection_batch_clear(DetectionBatch& batch)
+{
+    batch.count = 0;
+}
+
+/* r < 0: variance from range and weight. returns false if the batch is full. */
+inline bool detection_batch_push(DetectionBatch& batch, int id, double dx, double dy, double dz, double w,
+                                 double rx, double ry, double rz)
+{
+    if(batch.count >= DETECTION_BATCH_MAX)
+    {
+        return false;
+    }
+    const int i = batch.count++;
+    batch.id[i] = id;
+    batch.d[0][i] = dx;
+    batch.d[1][i] = dy;
+    batch.d[2][i] = dz;
+    batch.w[i] = w;
+    batch.r[0][i] = rx;
+    batch.r[1][i] = ry;
+    batch.r[2][i] = rz;
+    return true;
+}
+
+/* z = d + pos; r < 0 -> sigma_measurement^2 * max(range / range_nominal, 0.25)^2 / w
+ * (board_measurement_var() without the sqrt). */
+void detection_batch_transform(DetectionBatch& batch, const double pos[3], double sigma_measurement, double range_nominal);
+
+/* var += q, k = var / (var + r), d2 = sum (z - x)^2 / (var + r). x and var gathered by the caller. */
+void detection_batch_gate(DetectionBatch& batch, double q);
+
+#endif
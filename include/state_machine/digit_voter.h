@@ -0,0 +1,53 @@
+/**
+* @file     : digit_voter.h
+* @brief    : board num voting: the digits read in front of a board(vision_one_num_get) vote in a sliding
+*             window, a digit is decided once its posterior is above a confidence threshold. a misread
+*             only costs its vote instead of restarting MIN_OBSERVE_TIMES identical reads, and a clear
+*             digit is decided after a few reads(early exit).
+*             posterior: each read is right with probability 1 - misread, wrong reads alike over the
+*             other 9 digits, uniform prior -> P(leader) = 1 / sum_d rho^(votes_leader - votes_d),
+*             rho = misread / (9 * (1 - misread)).
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_DIGIT_VOTER_H
+#define STATE_MACHINE_DIGIT_VOTER_H
+
+#define DIGIT_VOTE_DIGITS 10
+#define DIGIT_VOTE_WINDOW_MAX 32
+#define DIGIT_VOTE_WINDOW 10            /* reads in the window. */
+#define DIGIT_VOTE_CONFIDENCE 0.99      /* misread 0.3: 3 votes ahead of any other digit. */
+#define DIGIT_VOTE_MISREAD 0.3          /* probability of a wrong read. */
+#define DIGIT_VOTE_MIN_VOTES 3
+
+struct DigitVoterConfig
+{
+    int window;             /* 1..DIGIT_VOTE_WINDOW_MAX */
+    double confidence;      /* posterior of the leader to decide. */
+    double misread;         /* (0, 0.9) */
+    int min_votes;          /* votes of the leader to decide. */
+};
+
+DigitVoterConfig digit_voter_default_config(void);
+
+/* plain data. */
+struct DigitVoter
+{
+    int read[DIGIT_VOTE_WINDOW_MAX];    /* ring buffer of the reads in the window. */
+    int head;                           /* next slot. */
+    int count;
+    int votes[DIGIT_VOTE_DIGITS];       /* histogram of the window. */
+    int leader;                         /* most voted digit, -1: no read. */
+    double confidence;                  /* posterior of the leader. */
+    int decided;                        /* digit decided, -1: none since reset. */
+};
+
+/* new board: window emptied, no digit decided. */
+void digit_voter_reset(DigitVoter& voter);
+
+/* read 0..9 into the window, the oldest read dropped once full. returns true if a digit is decided
+ * by this read: leader certain(confidence and min_votes) and not the digit decided already. */
+bool digit_voter_push(DigitVoter& voter, const DigitVoterConfig& config, int digit);
+
+#endif
@@ -0,0 +1,218 @@
+/**
+* @file     : mission.h
+* @brief    : mission of offb_simulation_test: mission states, mission context and transition table.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_MISSION_H
+#define STATE_MACHINE_MISSION_H
+
+#include <ros/ros.h>
+#include <geometry_msgs/PoseStamped.h>
+#include <geometry_msgs/TwistStamped.h>
+#include <state_machine/DrawingBoard10.h>
+#include <state_machine/FIXED_TARGET_POSITION_P2M.h>
+#include <state_machine/FIXED_TARGET_RETURN_M2P.h>
+#include <state_machine/mission_engine.h>
+#include <state_machine/settle_detector.h>
+#include <state_machine/spray_controller.h>
+#include <state_machine/mission_scheduler.h>
+#include <state_machine/retry_queue.h>
+
+/* on ros info msg */
+//#define NO_ROS_DEBUG
+
+/* select ROS rate */
+#ifdef NO_ROS_DEBUG
+#define ROS_RATE 20.0
+#else
+#define ROS_RATE 10.0
+#endif
+
+#define SPRAY_DISTANCE 2.2  /* distance from UAV to drawing board while sparying. */
+#define VISION_SCAN_DISTANCE 2.7  /* distance from UAV to drawing board while hoveing and scanning. */
+
+#define SAFE_HEIGHT_DISTANCE 0.42  /* distanche from drawing board's height to expected height: 0: real mission; >0: for safe. */
+#define FIXED_POS_HEIGHT 1.4    /* height of point: O */
+#define TAKEOFF_HEIGHT 1.8  /* height of point H. */
+
+#define SCAN_HEIGHT 1.6 /* constant height while scanning. */ //height of point: L, R
+#define SCAN_MOVE_SPEED 2 /* error bewteen pos* and pos. */
+#define SCAN_VISION_DISTANCE 4
+#define SCAN_SWEEP_SPEED 2.0    /* continuous scan: speed along the L-R baseline(m/s). */
+#define SCAN_SWEEP_TAU 0.5      /* continuous scan: slowing down within the last SCAN_SWEEP_TAU(s) of a pass. */
+#define SCAN_SWEEP_TURN 0.3     /* continuous scan: end of a pass within(m), no stop. */
+
+#define MAX_FLIGHT_TIME 240 /* max flight time of whole mission. */
+
+#define FAILURE_REPAIR 1    /* FAILURE_REPAIR: 0: never repair errores; 1: repair errors. */
+
+/* mission state. -libn */
+static const int takeoff = 1;
+static const int mission_hover_after_takeoff = 2;
+static const int mission_hover_only = 3;
+static const int mission_observe_point_go = 5;
+static const int mission_observe_num_wait = 6;
+static const int mission_num_search = 8;
+static const int mission_num_scan_again = 9;
+static const int mission_num_locate = 10;
+static const int mission_num_get_close = 11;
+static const int mission_arm_spread = 12;
+static const int mission_num_hover_spray = 13;
+static const int mission_num_done = 14;
+static const int mission_return_home = 15;
+static const int land = 16;
+static const int mission_end = 17;
+static const int mission_hover_before_spary = 18;
+static const int mission_fix_failure = 19;
+static const int mission_hover_after_stretch_back = 20;
+static const int mission_force_return_home = 21;
+
+/* state added for scanning mission. */
+static const int mission_scan_left_go = 31;
+static const int mission_scan_right_move = 32;
+static const int mission_scan_right_hover = 33;
+static const int mission_scan_left_move = 34;
+static const int mission_scan_left_hover = 35;
+static const int mission_scan_left2_hover = 36;
+static const int mission_scan_sweep_right = 37;  /* continuous scan: L -> R at constant speed. */
+static const int mission_scan_sweep_left = 38;   /* continuous scan: R -> L. */
+
+static const int MISSION_STATE_MAX = 38;
+
+/* mission events: arrival checks are done as soon as a new local position arrives. */
+static const unsigned MISSION_EVENT_POSE = 1;
+
+#define BOARD_NUM_MAX 10   /* drawing boards: num 0..9. */
+
+/* snapshots copied from messages on arrival: plain data only, no header(frame_id string) and no
+ * std::vector, so the mission tick and callbacks never touch the heap. */
+struct PoseSnapshot
+{
+    geometry_msgs::Point position;
+    ros::Time stamp;
+};
+
+struct VelocitySnapshot
+{
+    geometry_msgs::Vector3 linear;
+    ros::Time stamp;
+};
+
+struct BoardSnapshot
+{
+    float x;
+    float y;
+    float z;
+    bool valid;
+    uint32_t version;   /* DrawingBoard version, 0: not versioned. */
+};
+
+struct BoardSnapshots
+{
+    BoardSnapshot board[BOARD_NUM_MAX];
+    uint32_t epoch;     /* changed on a board map resync(board_mirror_apply): versions not comparable. */
+};
+
+/* board num from vision: vision_num_vote(voted, with its confidence) or vision_num(confidence 0). */
+struct NumSnapshot
+{
+    int num;
+    float confidence;
+};
+
+/* context of mission_fix_failure. */
+struct FailureFix
+{
+    bool retry;         /* entry popped from the retry queue: repaired from mission_num_search or a scan. */
+    RetryEntry entry;   /* retry in progress. */
+};
+
+struct MissionContext
+{
+    ros::Time now;  /* time of current tick/event, sampled once from MissionClock. */
+
+    /* vehicle and vision input. */
+    PoseSnapshot current_pos;
+    VelocitySnapshot current_vel;
+    BoardSnapshot board[BOARD_NUM_MAX];     /* 10 drawing board positions. -libn */
+
+    /* 4 setpoints. -libn */
+    geometry_msgs::PoseStamped setpoint_A;
+    geometry_msgs::PoseStamped setpoint_L;
+    geometry_msgs::PoseStamped setpoint_R;
+    geometry_msgs::PoseStamped setpoint_D;
+    geometry_msgs::PoseStamped setpoint_H;	/* home position. -libn */
+    float yaw_sp;   /* yaw*(ENU) in rad. */
+
+    int current_mission_num;	/* mission num: 5 subtask -> 5 current nums. -libn */
+    int last_mission_num;
+    float num_confidence;       /* of current_mission_num, 0: not known, hovered 1s before leaving. */
+
+    /* setpoint output. */
+    bool velocity_control_enable;
+    geometry_msgs::PoseStamped pose_pub;
+    geometry_msgs::TwistStamped vel_pub;	/* velocity setpoint to be published. -libn */
+
+    /* camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
+    int camera_switch;
+    bool camera_switch_pending;    /* camera_switch changed by mission, to be published. */
+
+    /* mission progress and timers. */
+    int loop;	/* loop calculator: loop = 0/1/2/3/4/5. -libn */
+    ros::Time mission_last_time;	/* timer used in mission. -libn */
+    ScheduleConfig schedule_config;
+    MissionSchedule schedule;   /* flight and loop budgets, started at takeoff. */
+    bool force_home_enable;
+    bool loop_timer_disable;
+    bool scan_to_get_pos;
+    bool scan_continuous;       /* sweep L-R at scan_sweep_speed, camera on, instead of stop-and-hover legs. */
+    double scan_sweep_speed;    /* m/s */
+
+    RetryQueue retry;           /* failed loops and retries, repaired after the 5 loops. */
+    int loop_timeout_count;     /* loops ended over budget by the scheduler. */
+
+    /* per-state context. */
+    SettleDetector settle;      /* hover states: settled -> switch to next state. */
+    double settle_saved;        /* dwell saved against the fixed hover timers(s). */
+    SprayConfig spray_config;   /* set after mission_init(node parameters, GCS spray_duration). */
+    SprayController spray;      /* mission_num_hover_spray: payload valve, output published by the node. */
+    SprayRecord spray_record[BOARD_NUM_MAX];
+    FailureFix fix_failure;
+};
+
+typedef state_machine::MissionEngine<MissionContext, MISSION_STATE_MAX> OffbMissionEngine;
+
+/* reset mission context to its state before takeoff. */
+void mission_init(MissionContext& ctx);
+
+/* callbacks: local position, local velocity and board positions -> snapshots. */
+void pose_snapshot(PoseSnapshot& pose, const geometry_msgs::PoseStamped& msg);
+void velocity_snapshot(VelocitySnapshot& vel, const geometry_msgs::TwistStamped& msg);
+void boards_snapshot(BoardSnapshots& boards, const state_machine::DrawingBoard10& msg);
+
+/* mission engine running the offb mission table, starting from initial_state. */
+OffbMissionEngine mission_engine(int initial_state = takeoff);
+
+/* scheduler, after every tick: cost left from pose and board map -> return home, defer, skip or stop loops. */
+void mission_timers(MissionContext& ctx, OffbMissionEngine& engine);
+
+/* every stream cycle(SETPOINT_RATE): valve closed once the spray time is delivered, not at the next tick. */
+void mission_spray_stream(MissionContext& ctx, const ros::Time& now);
+
+/* 4 fixed targets(NED) from GCS -> setpoint H/A/L/R(ENU) and yaw*, target_return: message returned to GCS. */
+void mission_fixed_targets(MissionContext& ctx,
+                           const state_machine::FIXED_TARGET_POSITION_P2M& target,
+                           state_machine::FIXED_TARGET_RETURN_M2P& target_return);
+
+/* limit angle_rad to [-pi,pi]. */
+float wrap_pi(float angle_rad);
+
+/* transform to ENU from NED. */
+void position_x_ENU_from_NED(float x_NED, float y_NED, float z_NED, float* pos_ENU_f);
+
+/* calculate distance */
+double circle_distance(double x1, double x2, double y1, double y2, double z1, double z2);
+
+#endif
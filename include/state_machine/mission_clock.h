@@ -0,0 +1,40 @@
+/**
+* @file     : mission_clock.h
+* @brief    : clock used by the mission: ROS time in flight, manual time for lockstep simulation.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_MISSION_CLOCK_H
+#define STATE_MACHINE_MISSION_CLOCK_H
+
+#include <ros/ros.h>
+
+class MissionClock
+{
+public:
+    virtual ~MissionClock() {}
+    virtual ros::Time now() const = 0;
+};
+
+/* ros::Time::now(): wall time or /clock. */
+class RosClock : public MissionClock
+{
+public:
+    ros::Time now() const { return ros::Time::now(); }
+};
+
+/* time moved by hand: mission can run faster than real time and deterministically. */
+class ManualClock : public MissionClock
+{
+public:
+    explicit ManualClock(const ros::Time& start = ros::Time(1.0)) : now_(start) {}
+    ros::Time now() const { return now_; }
+    void set(const ros::Time& t) { now_ = t; }
+    void advance(double seconds) { now_ = now_ + ros::Duration(seconds); }
+
+private:
+    ros::Time now_;
+};
+
+#endif
@@ -0,0 +1,196 @@
+/**
+* @file     : mission_engine.h
+* @brief    : table-driven mission engine: states, guards and actions are declared in a constant
+*             transition table and dispatched through a flat jump table indexed by state id.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_MISSION_ENGINE_H
+#define STATE_MACHINE_MISSION_ENGINE_H
+
+#include <cassert>
+#include <cstddef>
+
+namespace state_machine
+{
+
+/* events a transition is checked on besides the periodic tick(bit mask, bits defined by the mission). */
+static const unsigned MISSION_EVENT_NONE = 0;
+
+/* one mission state: action is run on every tick while the state is active(may be NULL). */
+template <typename Context>
+struct MissionState
+{
+    int id;
+    void (*action)(Context& ctx);
+};
+
+/* one edge of the transition table.
+ * guards of the same source state are checked in table order, the first one holding fires:
+ * effect(may be NULL) is run and the engine switches to state 'to'.
+ * every guard is checked on tick, guards with events set are also checked by react(). */
+template <typename Context>
+struct MissionTransition
+{
+    int from;
+    bool (*guard)(const Context& ctx);
+    void (*effect)(Context& ctx);
+    int to;
+    unsigned events;
+};
+
+/* MAX_STATE_ID: largest state id used in the tables, ids are used directly as jump table index. */
+template <typename Context, int MAX_STATE_ID>
+class MissionEngine
+{
+public:
+    /* transitions MUST be grouped by source state(checked by assert). */
+    template <std::size_t NS, std::size_t NT>
+    MissionEngine(const MissionState<Context> (&states)[NS],
+                  const MissionTransition<Context> (&transitions)[NT],
+                  int initial_state)
+    {
+        init(states, NS, transitions, NT, initial_state);
+    }
+
+    MissionEngine(const MissionState<Context>* states, std::size_t state_count,
+                  const MissionTransition<Context>* transitions, std::size_t transition_count,
+                  int initial_state)
+    {
+        init(states, state_count, transitions, transition_count, initial_state);
+    }
+
+    int state() const { return current_; }
+
+    /* switch state from outside of the table(timers, operator commands). */
+    void force(int id)
+    {
+        assert(id >= 0 && id <= MAX_STATE_ID && slots_[id].valid);
+        current_ = id;
+        acted_ = false;
+    }
+
+    /* run the action of the active state, then fire its first transition whose guard holds and run
+     * the action of the new state, as react() does. return true if a transition fired. */
+    bool tick(Context& ctx)
+    {
+        const Slot& slot = slots_[current_];
+        if(slot.action)
+        {
+            slot.action(ctx);
+        }
+        acted_ = true;
+        return fire(ctx, slot);
+    }
+
+    /* event arrived(e.g. new pose): check only the guards of the active state listening to it.
+     * on transition the action of the new state is run at once so its setpoint is not delayed
+     * until next tick. guards are not checked before the action of the active state has run
+     * (state entered by force), they would see the setpoint of the previous state.
+     * return true if a transition fired. */
+    bool react(Context& ctx, unsigned events)
+    {
+        if(!acted_)
+        {
+            return false;
+        }
+        const Slot& slot = slots_[current_];
+        const MissionTransition<Context>* t = transitions_ + slot.first;
+        const MissionTransition<Context>* end = t + slot.count;
+        for(; t != end; ++t)
+        {
+            if((t->events & events) && t->guard(ctx))
+            {
+                if(t->effect)
+                {
+                    t->effect(ctx);
+                }
+                current_ = t->to;
+                if(slots_[current_].action)
+                {
+                    slots_[current_].action(ctx);
+                }
+                acted_ = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Slot
+    {
+        void (*action)(Context& ctx);
+        std::size_t first;  /* first transition of this state in transitions_. */
+        std::size_t count;
+        bool valid;
+    };
+
+    void init(const MissionState<Context>* states, std::size_t state_count,
+              const MissionTransition<Context>* transitions, std::size_t transition_count,
+              int initial_state)
+    {
+        for(int i = 0; i <= MAX_STATE_ID; ++i)
+        {
+            slots_[i].action = NULL;
+            slots_[i].first = 0;
+            slots_[i].count = 0;
+            slots_[i].valid = false;
+        }
+        for(std::size_t i = 0; i < state_count; ++i)
+        {
+            assert(states[i].id >= 0 && states[i].id <= MAX_STATE_ID);
+            slots_[states[i].id].action = states[i].action;
+            slots_[states[i].id].valid = true;
+        }
+        for(std::size_t i = 0; i < transition_count; ++i)
+        {
+            assert(slots_[transitions[i].from].valid && slots_[transitions[i].to].valid);
+            Slot& slot = slots_[transitions[i].from];
+            if(slot.count == 0)
+            {
+                slot.first = i;
+            }
+            assert(slot.first + slot.count == i);   /* transitions not grouped by source state. */
+            slot.count++;
+        }
+        transitions_ = transitions;
+        current_ = initial_state;
+        acted_ = false;
+        assert(slots_[current_].valid);
+    }
+
+    bool fire(Context& ctx, const Slot& slot)
+    {
+        const MissionTransition<Context>* t = transitions_ + slot.first;
+        const MissionTransition<Context>* end = t + slot.count;
+        for(; t != end; ++t)
+        {
+            if(t->guard(ctx))
+            {
+                if(t->effect)
+                {
+                    t->effect(ctx);
+                }
+                current_ = t->to;
+                if(slots_[current_].action)
+                {
+                    slots_[current_].action(ctx);
+                }
+                acted_ = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Slot slots_[MAX_STATE_ID + 1];
+    const MissionTransition<Context>* transitions_;
+    int current_;
+    bool acted_;    /* action of current_ has run since it was entered. */
+};
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+/**
+* @file     : mission_harness.h
+* @brief    : headless lockstep harness: runs the offb mission against a simple vehicle model and a
+*             scripted vision feed on a ManualClock, no roscore needed, faster than real time.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_MISSION_HARNESS_H
+#define STATE_MACHINE_MISSION_HARNESS_H
+
+#include <state_machine/mission.h>
+#include <state_machine/mission_clock.h>
+#include <state_machine/setpoint_streamer.h>
+#include <state_machine/board_detector.h>
+#include <state_machine/board_mirror.h>
+
+#include <random>
+
+struct HarnessConfig
+{
+    double tick_period;     /* mission tick period(s), 1/ROS_RATE in flight. */
+    int pose_per_tick;      /* local position updates per mission tick. */
+    double time_limit;      /* stop if not landed after this time(s). */
+    bool event_driven;      /* react() on every pose update, as offb_simulation_test does by default. */
+
+    /* vehicle model: first order position tracking with speed and acceleration limits. */
+    double vehicle_tau;     /* time constant(s). */
+    double max_speed;       /* m/s */
+    double max_acceleration;    /* m/s^2, 0: none. */
+    TrajectoryLimits trajectory;    /* setpoint streamer. */
+    bool feed_forward;      /* trajectory velocity added to the position loop(PositionTarget), as the node does by default. */
+
+    /* field: home position, scan setpoints L/R, observe point A and 10 boards. */
+    geometry_msgs::Point home;
+    geometry_msgs::Point setpoint_A;
+    geometry_msgs::Point setpoint_L;
+    geometry_msgs::Point setpoint_R;
+    float yaw_sp;
+    state_machine::DrawingBoard board[10];  /* true board positions, valid: board exists. */
+
+    /* vision: boards closer than vision_range are detected, mission_num[loop] is read while
+     * camera_switch == 1. the frames go through BoardDetector and BoardMirror as they do through
+     * get_board_position and offb_simulation_test. */
+    double vision_range;
+    bool background_mapping;    /* boards also mapped in the other phases(BoardDetector phase weight). */
+    int mission_num[6];
+
+    /* disturbances, 0: none. */
+    unsigned seed;          /* random seed of noise, dropout and wind. */
+    double vision_noise;    /* std dev of reported board position(m). */
+    double vision_dropout;  /* probability of a vision update being lost. */
+    double num_misread;     /* probability of a num read being another digit. */
+    double wind;            /* std dev of disturbance velocity left after position control(m/s). */
+};
+
+struct HarnessResult
+{
+    bool landed;
+    double flight_time;     /* from takeoff to land or time limit(s). */
+    int loop_timeouts;
+    int failures;           /* failures in the retry queue when mission stopped. */
+    int failures_max;       /* largest retry queue during the mission. */
+    int sprays;             /* boards sprayed. */
+    double spray_time;      /* valve open, all boards(s). */
+    double spray_latency;   /* spray point reached -> valve open, all boards(s). */
+    int ticks;
+};
+
+/* default field: boards in a row 6 m north of home, scanned from 4 m. */
+HarnessConfig harness_default_config(void);
+
+class MissionHarness
+{
+public:
+    explicit MissionHarness(const HarnessConfig& config);
+    virtual ~MissionHarness() {}
+
+    /* run the whole mission from takeoff until land or time_limit. */
+    HarnessResult run(void);
+
+    /* one mission tick: pose_per_tick vehicle/vision updates, then tick and timers.
+     * return false once landed or out of time. */
+    bool step(void);
+
+    const MissionContext& context(void) const { return ctx_; }
+    int state(void) const { return engine_.state(); }
+    const HarnessResult& result(void) const { return result_; }
+
+protected:
+    /* vision feed, called after every pose update. */
+    virtual void vision_update(void);
+
+    /* vehicle model, moves current_pos/current_vel for dt seconds. */
+    virtual void vehicle_update(double dt);
+
+    HarnessConfig config_;
+    ManualClock clock_;
+    MissionContext ctx_;
+    OffbMissionEngine engine_;
+    SetpointStreamer streamer_;
+    ros::Time start_time_;
+    HarnessResult result_;
+    std::mt19937 rng_;
+    geometry_msgs::Vector3 disturbance_;
+    geometry_msgs::Vector3 vehicle_vel_;    /* without wind. */
+    BoardDetector detector_;                /* get_board_position. */
+    state_machine::BoardDetections detections_;
+    state_machine::BoardMapDelta delta_;
+    ros::Time last_keyframe_;
+    BoardMirror mirror_;                    /* offb_simulation_test. */
+    uint32_t board_epoch_;
+    bool boards_pending_;                   /* mirror changed, not copied into the mission yet. */
+
+private:
+    void setpoint_update(void);
+};
+
+#endif
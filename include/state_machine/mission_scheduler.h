@@ -0,0 +1,97 @@
+/**
+* @file     : mission_scheduler.h
+* @brief    : mission scheduler: explicit time budget for takeoff/scan(loop 0) and each board loop(1~5),
+*             replacing the flight timer(MAX_FLIGHT_TIME + 30s per failure) and the loop timer(loop*30+50).
+*             the mission estimates the cost left from pose and board map, the scheduler decides whether
+*             the current loop is finished, deferred(repaired later) or skipped, and when to go home so
+*             that the return still fits in the flight budget. budget state is published as MissionBudget.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_MISSION_SCHEDULER_H
+#define STATE_MACHINE_MISSION_SCHEDULER_H
+
+#include <ros/ros.h>
+#include <state_machine/MissionBudget.h>
+
+#define SCHEDULE_LOOPS 5            /* board loops. */
+#define SCHEDULE_SCAN_COST 50.0     /* loop 0 budget: takeoff and scan(s), loop timer used before. */
+#define SCHEDULE_LOOP_COST 30.0     /* first estimate of a board loop(s), loop timer used before. */
+
+/* values of MissionBudget decision. */
+enum ScheduleDecision
+{
+    SCHEDULE_CONTINUE = 0,  /* within budget, or finishing the loop is cheaper than a new one. */
+    SCHEDULE_DEFER,         /* loop(or retry) over budget: board queued for repair. */
+    SCHEDULE_SKIP,          /* loop over budget, remaining loops already exceed the budget: next loop. */
+    SCHEDULE_STOP,          /* current loop cannot be finished in time: no more loops. */
+    SCHEDULE_RETURN_HOME,   /* flight budget left only covers return and land. */
+};
+
+struct ScheduleConfig
+{
+    double flight_budget;   /* takeoff -> landed(s). */
+    double scan_cost;       /* loop 0 budget(s). */
+    double loop_cost;       /* first loop estimate(s). */
+    double cruise_speed;    /* moves: distance / cruise_speed + move_overhead. */
+    double move_overhead;   /* acceleration, braking and reaching the setpoint(s). */
+    double land_cost;       /* hover and land at home(s). */
+    double margin;          /* flight budget kept in reserve(s). */
+    double learn_rate;      /* weight of a loop flown in the loop estimate. */
+};
+
+/* MAX_FLIGHT_TIME budget, SCHEDULE_SCAN_COST, SCHEDULE_LOOP_COST. */
+ScheduleConfig schedule_default_config();
+
+/* plain data: kept in the mission context. */
+struct MissionSchedule
+{
+    bool started;
+    ros::Time start;        /* takeoff. */
+    ros::Time loop_start;
+    int loop;               /* loop budgeted. */
+    bool repair;            /* loop > SCHEDULE_LOOPS: a retry budgeted by schedule_repair(). */
+    double elapsed;
+    double remaining;       /* flight budget left(s). */
+    double loop_elapsed;
+    double loop_budget;     /* time allotted to the current loop(s). */
+    double grace;           /* over budget: extra time to finish the loop(s), < 0: within budget. */
+    double loop_estimate;   /* expected cost of a board loop(s), learnt from loops finished. */
+    double task_left;       /* cost to finish the current loop, estimated by the mission(s). */
+    double home_cost;       /* cost to return and land from here(s). */
+    double slack;           /* remaining - loops left - return - margin(s). */
+    ScheduleDecision decision;
+    int finished;
+    int deferred;
+    int skipped;
+};
+
+void schedule_reset(MissionSchedule& schedule, const ScheduleConfig& config);
+
+/* takeoff: flight budget starts. */
+void schedule_start(MissionSchedule& schedule, const ros::Time& now);
+
+/* estimated time of a move over distance(m). */
+double schedule_move_cost(const ScheduleConfig& config, double distance);
+
+/* once per mission tick: loop(0~5, >5 repair and return), task_left and home_cost(s) from the mission.
+ * a new loop number starts a new loop budget. returns the decision, kept until the next update. */
+ScheduleDecision schedule_update(MissionSchedule& schedule, const ScheduleConfig& config, const ros::Time& now,
+                                 int loop, double task_left, double home_cost);
+
+/* retry of a failure started(after the loops): budgeted like a loop until the next loop number. */
+void schedule_repair(MissionSchedule& schedule, double budget, const ros::Time& now);
+
+/* flight budget left before the return(s): loops and repairs. */
+double schedule_available(const MissionSchedule& schedule, const ScheduleConfig& config);
+
+/* decision acted on by the mission: loop counters. */
+void schedule_loop_ended(MissionSchedule& schedule, ScheduleDecision decision);
+
+const char* schedule_decision_name(ScheduleDecision decision);
+
+/* budget state -> telemetry message. */
+void schedule_telemetry(const MissionSchedule& schedule, const ros::Time& now, state_machine::MissionBudget& msg);
+
+#endif
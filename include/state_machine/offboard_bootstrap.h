@@ -0,0 +1,74 @@
+/**
+* @file     : offboard_bootstrap.h
+* @brief    : start-up: stream setpoints at SETPOINT_RATE, watch mavros/state and request OFFBOARD and
+*             arming as soon as PX4 accepts them(instead of 100 setpoints at 10Hz and 5s retries).
+*             node start -> connected -> stream ready -> OFFBOARD -> armed is timed.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_OFFBOARD_BOOTSTRAP_H
+#define STATE_MACHINE_OFFBOARD_BOOTSTRAP_H
+
+#include <ros/ros.h>
+#include <state_machine/vehicle_state.h>
+
+enum BootstrapRequest
+{
+    BOOTSTRAP_NONE = 0,
+    BOOTSTRAP_SET_OFFBOARD,
+    BOOTSTRAP_ARM,
+};
+
+struct BootstrapConfig
+{
+    double min_stream_time;     /* setpoints streamed after connection before OFFBOARD is requested(s). */
+    double retry_interval;      /* after a rejected or lost request(s). */
+    bool request_offboard;      /* false: pilot switches to OFFBOARD. */
+    bool request_arm;           /* false: pilot arms. */
+};
+
+/* 1s stream, 0.5s retry, pilot switches and arms. */
+BootstrapConfig bootstrap_default_config();
+
+class OffboardBootstrap
+{
+public:
+    OffboardBootstrap(const BootstrapConfig& config, const ros::Time& start);
+
+    /* once per stream cycle, after the setpoint is published.
+     * request_pending: previous request not answered yet(no new request is made meanwhile).
+     * returns the request the node has to send now. */
+    BootstrapRequest update(const VehicleState& state, const ros::Time& now, bool request_pending);
+
+    /* connected and setpoints streamed for min_stream_time: PX4 accepts OFFBOARD. */
+    bool stream_ready() const { return stream_ready_; }
+
+    /* armed in OFFBOARD. */
+    bool done() const { return done_; }
+
+    /* seconds from start, negative until reached. */
+    double time_connected() const { return time_connected_; }
+    double time_stream_ready() const { return time_stream_ready_; }
+    double time_offboard() const { return time_offboard_; }
+    double time_armed() const { return time_armed_; }
+
+    /* ROS_INFO of the start-up times. */
+    void report() const;
+
+private:
+    BootstrapConfig config_;
+    ros::Time start_;
+    ros::Time connected_at_;
+    ros::Time last_request_;
+    BootstrapRequest last_request_type_;
+    bool connected_;
+    bool stream_ready_;
+    bool done_;
+    double time_connected_;
+    double time_stream_ready_;
+    double time_offboard_;
+    double time_armed_;
+};
+
+#endif
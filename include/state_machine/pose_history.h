@@ -0,0 +1,44 @@
+/**
+* @file     : pose_history.h
+* @brief    : pose history: fixed-size ring buffer of local positions keyed by header stamp, looked up
+*             with linear interpolation, so that a vision detection is placed with the pose at the
+*             capture time of its image instead of the latest pose.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_POSE_HISTORY_H
+#define STATE_MACHINE_POSE_HISTORY_H
+
+#include <ros/ros.h>
+#include <geometry_msgs/Point.h>
+
+#define POSE_HISTORY_SIZE 64    /* local position at 50Hz: 1.28s. */
+
+/* result of pose_history_at. */
+enum PoseLookup
+{
+    POSE_NONE = 0,          /* history empty. */
+    POSE_INTERPOLATED,      /* between two poses. */
+    POSE_LATEST,            /* newer than the latest pose(or no stamp): latest pose. */
+    POSE_OLDEST,            /* older than the history: oldest pose. */
+};
+
+/* plain data. */
+struct PoseHistory
+{
+    ros::Time stamp[POSE_HISTORY_SIZE];
+    geometry_msgs::Point position[POSE_HISTORY_SIZE];
+    int head;               /* next slot. */
+    int count;
+};
+
+void pose_history_reset(PoseHistory& history);
+
+/* stamps must increase: an older or equal stamp is dropped(returns false). */
+bool pose_history_push(PoseHistory& history, const ros::Time& stamp, const geometry_msgs::Point& position);
+
+/* position at stamp. */
+PoseLookup pose_history_at(const PoseHistory& history, const ros::Time& stamp, geometry_msgs::Point& position);
+
+#endif
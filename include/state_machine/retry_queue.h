@@ -0,0 +1,59 @@
+/**
+* @file     : retry_queue.h
+* @brief    : failure retry queue: one entry per board(a board failing again is merged, no failure is
+*             dropped for capacity), retry policy and attempts per failure. the repair phase takes the
+*             cheapest entry that still fits in the flight budget, costs estimated by the mission.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_RETRY_QUEUE_H
+#define STATE_MACHINE_RETRY_QUEUE_H
+
+#define RETRY_BOARDS_MAX 10     /* board nums 0..9(BOARD_NUM_MAX). */
+
+enum RetryPolicy
+{
+    RETRY_NONE = 0,     /* sprayed already or num not read: not retried. */
+    RETRY_APPROACH,     /* failed on the way to a known board: fly to it again(mission_num_search). */
+    RETRY_HOVER,        /* failed at the spray point(not settled): once more from mission_num_search. */
+    RETRY_SCAN,         /* board position unknown: scan for it first. */
+};
+
+struct RetryEntry
+{
+    int num;            /* board num. */
+    int state;          /* mission state failed in(last failure). */
+    RetryPolicy policy;
+    int attempts;       /* retries started. */
+    int max_attempts;
+    double cost;        /* estimate to repair from the current pose(s), set before retry_pop(). */
+};
+
+/* plain data: kept in the mission context. */
+struct RetryQueue
+{
+    RetryEntry entry[RETRY_BOARDS_MAX];
+    int count;
+    int recorded;       /* failures pushed. */
+    int started;        /* retries started. */
+    int recovered;      /* boards sprayed by a retry. */
+    int dropped;        /* no policy or out of attempts. */
+};
+
+void retry_reset(RetryQueue& queue);
+
+/* retries of a policy: approach 2, hover 1, scan 1, none 0. */
+int retry_policy_attempts(RetryPolicy policy);
+
+const char* retry_policy_name(RetryPolicy policy);
+
+/* failure of board num in state, attempts: retries of it made already(0: failed in its loop).
+ * new entry or merged into the board's entry. returns false if dropped(no policy, out of attempts). */
+bool retry_push(RetryQueue& queue, int num, int state, RetryPolicy policy, int attempts);
+
+/* entry with the lowest cost not above budget(s) removed into retry, attempts counted.
+ * returns false if none fits. */
+bool retry_pop(RetryQueue& queue, double budget, RetryEntry& retry);
+
+#endif
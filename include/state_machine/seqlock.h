@@ -0,0 +1,88 @@
+/**
+* @file     : seqlock.h
+* @brief    : latest-value snapshot shared by one writer(callback thread) and any number of readers
+*             (control loop): readers never block the writer and never take a lock.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_SEQLOCK_H
+#define STATE_MACHINE_SEQLOCK_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+/* T MUST be plain data(copied with memcpy), e.g. PoseSnapshot, VehicleState.
+ * value is kept in atomic words so that a read racing with a write is not undefined behaviour,
+ * a torn read is detected by the sequence number and retried. */
+template <typename T>
+class Seqlock
+{
+public:
+    Seqlock() : seq_(0)
+    {
+        T value = T();
+        store(value);
+    }
+
+    /* single writer only. */
+    void write(const T& value)
+    {
+        unsigned seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);     /* odd: write in progress. */
+        std::atomic_thread_fence(std::memory_order_release);
+        store(value);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    /* copy latest value, return its sequence number(0: never written, +2 per write). */
+    unsigned read(T& value) const
+    {
+        for(;;)
+        {
+            unsigned seq0 = seq_.load(std::memory_order_acquire);
+            if(seq0 & 1)
+            {
+                continue;   /* writer busy for a few ns. */
+            }
+            load(value);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(seq_.load(std::memory_order_relaxed) == seq0)
+            {
+                return seq0;
+            }
+        }
+    }
+
+    unsigned sequence() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    void store(const T& value)
+    {
+        uint64_t buf[WORDS];
+        buf[WORDS - 1] = 0;
+        memcpy(buf, &value, sizeof(T));
+        for(size_t i = 0; i < WORDS; ++i)
+        {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+    }
+
+    void load(T& value) const
+    {
+        uint64_t buf[WORDS];
+        for(size_t i = 0; i < WORDS; ++i)
+        {
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        memcpy(&value, buf, sizeof(T));
+    }
+
+    std::atomic<unsigned> seq_;
+    std::atomic<uint64_t> words_[WORDS];
+};
+
+#endif
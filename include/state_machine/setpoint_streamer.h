@@ -0,0 +1,69 @@
+/**
+* @file     : setpoint_streamer.h
+* @brief    : setpoint streamer: position targets come from the mission at ROS_RATE,
+*             setpoints are published at SETPOINT_RATE along a minimum-jerk trajectory to the target,
+*             as PoseStamped(position only) or PositionTarget(position, velocity and acceleration feed-forward).
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_SETPOINT_STREAMER_H
+#define STATE_MACHINE_SETPOINT_STREAMER_H
+
+#include <ros/ros.h>
+#include <geometry_msgs/PoseStamped.h>
+#include <state_machine/PositionTarget.h>
+#include <state_machine/trajectory.h>
+
+#define SETPOINT_RATE 50.0  /* setpoint streaming rate(Hz), multiple of ROS_RATE. */
+
+/* PositionTarget type_mask: position with velocity and acceleration feed-forward, yaw. */
+static const uint16_t POSITION_TARGET_FEED_FORWARD = state_machine::PositionTarget::IGNORE_YAW_RATE;
+
+/* PositionTarget type_mask: velocity only, yaw. */
+static const uint16_t POSITION_TARGET_VELOCITY =
+    state_machine::PositionTarget::IGNORE_PX | state_machine::PositionTarget::IGNORE_PY | state_machine::PositionTarget::IGNORE_PZ |
+    state_machine::PositionTarget::IGNORE_AFX | state_machine::PositionTarget::IGNORE_AFY | state_machine::PositionTarget::IGNORE_AFZ |
+    state_machine::PositionTarget::IGNORE_YAW_RATE;
+
+class SetpointStreamer
+{
+public:
+    explicit SetpointStreamer(const TrajectoryLimits& limits);
+
+    /* jump to position and hold it. */
+    void reset(const geometry_msgs::Point& position, const ros::Time& now);
+
+    /* hold position, the next target is planned from position and velocity(measured while velocity
+     * control is used): no stop at the handoff to position control. */
+    void reset(const geometry_msgs::Point& position, const geometry_msgs::Vector3& velocity, const ros::Time& now);
+
+    /* new target from mission: re-plan from the setpoint state streamed now. */
+    void set_target(const geometry_msgs::Point& target, const ros::Time& now);
+
+    /* setpoint to be published at time now. */
+    geometry_msgs::Point sample(const ros::Time& now) const;
+
+    /* setpoint with its velocity and acceleration. */
+    TrajectoryState sample_state(const ros::Time& now) const;
+
+    /* setpoint at time now with velocity and acceleration feed-forward(POSITION_TARGET_FEED_FORWARD),
+     * header stamp and frame included. yaw(ENU, rad). */
+    void position_target(const ros::Time& now, double yaw, state_machine::PositionTarget& target) const;
+
+private:
+    TrajectoryLimits limits_;
+    MinJerkTrajectory trajectory_;
+    ros::Time start_;
+    bool handoff_;                  /* next target planned from handoff_state_. */
+    TrajectoryState handoff_state_;
+};
+
+/* velocity control as PositionTarget(POSITION_TARGET_VELOCITY). */
+void velocity_target(const ros::Time& now, const geometry_msgs::Vector3& velocity, double yaw,
+                     state_machine::PositionTarget& target);
+
+/* yaw(rad) of a quaternion. */
+double quaternion_yaw(const geometry_msgs::Quaternion& q);
+
+#endif
@@ -0,0 +1,49 @@
+/**
+* @file     : settle_detector.h
+* @brief    : settle detector: hover is "settled" once, over a sliding window, the distance to the
+*             setpoint is small and steady(mean + 2 sigma within radius) and the speed is low,
+*             instead of fixed hover timers and successive-check counters.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_SETTLE_DETECTOR_H
+#define STATE_MACHINE_SETTLE_DETECTOR_H
+
+#include <ros/ros.h>
+
+#define SETTLE_SAMPLES_MAX 32   /* window samples kept(mission ticks or pose updates). */
+
+struct SettleConfig
+{
+    double radius;          /* distance to setpoint: mean + 2 sigma within(m). */
+    double speed;           /* max speed in window(m/s). */
+    double window;          /* sliding window(s). */
+    double min_dwell;       /* never settled earlier(s), e.g. time for a mechanism. */
+    double max_dwell;       /* settled anyway(s), as the fixed timers forced it before. */
+    double legacy_dwell;    /* dwell of the fixed timer replaced(s): saved time is logged against it. */
+};
+
+/* plain data: kept in the mission context, reset when a state starts using it. */
+struct SettleDetector
+{
+    int state;              /* mission state sampling(0: none). */
+    ros::Time start;
+    ros::Time stamp[SETTLE_SAMPLES_MAX];
+    float error[SETTLE_SAMPLES_MAX];
+    float speed[SETTLE_SAMPLES_MAX];
+    int head;               /* next sample slot. */
+    int count;
+    bool done;
+    bool forced;            /* done by max_dwell. */
+};
+
+void settle_reset(SettleDetector& detector, int state, const ros::Time& now);
+
+/* new sample: distance to setpoint and speed. sets done. */
+void settle_update(SettleDetector& detector, const SettleConfig& config, const ros::Time& now, double error, double speed);
+
+/* time spent since settle_reset. */
+double settle_dwell(const SettleDetector& detector, const ros::Time& now);
+
+#endif
@@ -0,0 +1,77 @@
+/**
+* @file     : spray_controller.h
+* @brief    : spray phase: the payload valve(ActuatorControl, PX4_MIX_PAYLOAD group) opens as soon as the
+*             vehicle has settled at the spray point and closes once the configured spray time is delivered,
+*             instead of a fixed 3s hold. spray start latency and spray time are recorded per board.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_SPRAY_CONTROLLER_H
+#define STATE_MACHINE_SPRAY_CONTROLLER_H
+
+#include <ros/ros.h>
+#include <state_machine/ActuatorControl.h>
+
+#define SPRAY_DURATION 1.0      /* default spray time per board(s), GCS default spray_duration. */
+#define SPRAY_WAIT_MAX 1.5      /* valve opened anyway if not settled(s). */
+#define SPRAY_CHANNEL 0         /* payload group control of the valve. */
+
+enum SprayPhase
+{
+    SPRAY_IDLE = 0,
+    SPRAY_WAIT,     /* at spray point, valve closed until settled. */
+    SPRAY_ON,
+    SPRAY_DONE,     /* spray time delivered, valve closed. */
+};
+
+struct SprayConfig
+{
+    double duration;    /* spray time per board(s), GCS spray_duration. */
+    double max_wait;    /* spray started anyway after this wait(s). */
+    int channel;        /* payload control 0..7. */
+    float on;           /* control value: valve open(-1..1). */
+    float off;          /* control value: valve closed. */
+};
+
+/* SPRAY_DURATION, SPRAY_WAIT_MAX, SPRAY_CHANNEL, 1 open, -1 closed. */
+SprayConfig spray_default_config();
+
+/* last spray of a board. */
+struct SprayRecord
+{
+    int count;          /* sprays of the board(0: never sprayed). */
+    double latency;     /* spray point reached -> valve open(s). */
+    double sprayed;     /* valve open time(s). */
+    bool forced;        /* opened by max_wait, not settled. */
+};
+
+/* plain data: kept in the mission context. */
+struct SprayController
+{
+    SprayPhase phase;
+    int board;
+    ros::Time enter;    /* spray point reached. */
+    ros::Time on_at;
+    ros::Time off_at;
+    bool forced;
+    bool output_pending;    /* valve changed: output to be published. */
+    state_machine::ActuatorControl output;
+};
+
+/* valve closed, output published once. */
+void spray_reset(SprayController& spray, const SprayConfig& config);
+
+/* spray point of board reached. settled: valve opened now, otherwise after spray_update() is settled. */
+void spray_start(SprayController& spray, const SprayConfig& config, int board, const ros::Time& now, bool settled);
+
+/* once per tick of the spray state: opens and closes the valve. */
+void spray_update(SprayController& spray, const SprayConfig& config, const ros::Time& now, bool settled);
+
+/* valve closed before the spray time was delivered(mission forced elsewhere). */
+void spray_abort(SprayController& spray, const SprayConfig& config, const ros::Time& now);
+
+/* spray just ended -> record of its board. */
+void spray_record(const SprayController& spray, SprayRecord& record);
+
+#endif
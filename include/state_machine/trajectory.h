@@ -0,0 +1,75 @@
+/**
+* @file     : trajectory.h
+* @brief    : minimum-jerk trajectory from the current setpoint state(position, velocity, acceleration)
+*             to a mission target at rest, duration chosen to keep velocity and acceleration limits.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_TRAJECTORY_H
+#define STATE_MACHINE_TRAJECTORY_H
+
+#include <geometry_msgs/Point.h>
+#include <geometry_msgs/Vector3.h>
+
+#define TRAJECTORY_VELOCITY_MAX 2.0        /* m/s */
+#define TRAJECTORY_ACCELERATION_MAX 2.5    /* m/s^2 */
+
+struct TrajectoryLimits
+{
+    double max_velocity;        /* <= 0: no trajectory, setpoint jumps to the target. */
+    double max_acceleration;
+    double min_duration;    /* s, also used for moves of a few mm. */
+};
+
+/* TRAJECTORY_VELOCITY_MAX, TRAJECTORY_ACCELERATION_MAX, min_duration(normally one mission period). */
+TrajectoryLimits trajectory_default_limits(double min_duration);
+
+struct TrajectoryState
+{
+    geometry_msgs::Point position;
+    geometry_msgs::Vector3 velocity;
+    geometry_msgs::Vector3 acceleration;
+};
+
+/* long moves: straight line with minimum-jerk velocity ramps(velocity from the planning state along
+ * the line -> cruise -> 0) and a quintic correction decaying the rest of the initial velocity and
+ * acceleration. moves that cannot stop in time: single quintic per axis(overshoots smoothly).
+ * position, velocity and acceleration are continuous at planning time and zero at the target. */
+class MinJerkTrajectory
+{
+public:
+    MinJerkTrajectory();
+
+    /* hold position(at rest). */
+    void reset(const geometry_msgs::Point& position);
+
+    /* from state(normally sample() at planning time) to target. */
+    void plan(const TrajectoryState& from, const geometry_msgs::Point& target, const TrajectoryLimits& limits);
+
+    /* t: seconds since planning, held at the target after duration(). */
+    TrajectoryState sample(double t) const;
+
+    double duration() const { return duration_; }
+    const geometry_msgs::Point& target() const { return target_; }
+
+private:
+    void line_sample(double t, double& s, double& v, double& a) const;
+    void plan_quintic(const TrajectoryState& from, const geometry_msgs::Point& target, const TrajectoryLimits& limits);
+
+    double origin_[3];      /* line start. */
+    double direction_[3];   /* unit vector, 0 for a quintic only move. */
+    double v_start_;        /* line speed at planning time. */
+    double v_cruise_;
+    double t_accel_;
+    double t_cruise_;
+    double t_decel_;
+    double s_accel_;        /* line length of the ramp up and the cruise. */
+    double s_cruise_;
+    double coeff_[3][6];    /* correction x,y,z: c0 + c1*t + ... + c5*t^5 */
+    double t_correction_;
+    double duration_;
+    geometry_msgs::Point target_;
+};
+
+#endif
@@ -0,0 +1,51 @@
+/**
+* @file     : vehicle_state.h
+* @brief    : vehicle state(mavros/state) with the flight mode interned to an enum on arrival:
+*             the main loop compares modes without string compares or string copies.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#ifndef STATE_MACHINE_VEHICLE_STATE_H
+#define STATE_MACHINE_VEHICLE_STATE_H
+
+#include <state_machine/State.h>
+
+/* PX4 custom modes as reported by mavros. */
+enum FlightMode
+{
+    MODE_UNKNOWN = 0,
+    MODE_MANUAL,
+    MODE_ACRO,
+    MODE_ALTCTL,
+    MODE_POSCTL,
+    MODE_OFFBOARD,
+    MODE_STABILIZED,
+    MODE_RATTITUDE,
+    MODE_AUTO_MISSION,
+    MODE_AUTO_LOITER,
+    MODE_AUTO_RTL,
+    MODE_AUTO_LAND,
+    MODE_AUTO_RTGS,
+    MODE_AUTO_READY,
+    MODE_AUTO_TAKEOFF,
+};
+
+struct VehicleState
+{
+    bool connected;
+    bool armed;
+    bool guided;
+    FlightMode mode;
+};
+
+/* mode string -> enum, MODE_UNKNOWN for modes not listed above. */
+FlightMode flight_mode_from_string(const std::string& mode);
+
+/* enum -> mode string(for display and set_mode requests). */
+const char* flight_mode_name(FlightMode mode);
+
+/* state_cb: copy the state message without its header and mode string. */
+void vehicle_state_update(VehicleState& state, const state_machine::State& msg);
+
+#endif
@@ -0,0 +1,334 @@
+/**
+* @file     : board_detector.cpp
+* @brief    : vision detections of get_board_position -> stable mission num and board positions.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/board_detector.h>
+
+#include <ros/ros.h>
+#include <math.h>
+
+BoardMappingConfig board_mapping_default_config()
+{
+    BoardMappingConfig mapping;
+    mapping.background = true;
+    mapping.weight[0] = BOARD_MAPPING_WEIGHT_TRANSIT;
+    mapping.weight[1] = BOARD_MAPPING_WEIGHT_NUM;
+    mapping.weight[2] = BOARD_MAPPING_WEIGHT_SCAN;
+    return mapping;
+}
+
+BoardDetector::BoardDetector()
+    : mapping_(board_mapping_default_config()),
+      estimator_(board_estimator_default_config()),
+      batch_serial_(0),
+      delta_seq_(0),
+      voter_config_(digit_voter_default_config()),
+      vision_num_(0),
+      num_updated_(false)
+{
+    digit_voter_reset(voter_);
+}
+
+double BoardDetector::mapping_weight(int camera_switch) const
+{
+    if(camera_switch < 0 || camera_switch > 2 || (camera_switch != 2 && !mapping_.background))
+    {
+        return 0.0;
+    }
+    return mapping_.weight[camera_switch];
+}
+
+unsigned BoardDetector::update(int camera_switch, const sensor_msgs::LaserScan& scan, const geometry_msgs::Point& current_pos)
+{
+    unsigned updated = 0;
+    if(scan.ranges.size() < 3)
+    {
+        return updated;
+    }
+
+    /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
+    num_votes_restart(camera_switch);
+    if(camera_switch == 1 && scan.ranges[1] > 100 && scan.ranges[2] > 100)
+    {
+        num_update((int)scan.ranges[0]);
+        if(num_updated_)
+        {
+            updated |= BOARD_NUM_UPDATED;
+        }
+    }
+
+    /* positions: scanning, or background mapping in the other phases. */
+    double weight = mapping_weight(camera_switch);
+    if(weight > 0.0 && scan.ranges[1] < 100 && scan.ranges[2] < 100)
+    {
+        scan_update(scan, current_pos, weight);
+    }
+    if(!dirty_.empty())
+    {
+        updated |= BOARD_POSITION_UPDATED;
+    }
+    return updated;
+}
+
+unsigned BoardDetector::update(int camera_switch, const state_machine::BoardDetections& msg, const geometry_msgs::Point& current_pos)
+{
+    unsigned updated = 0;
+    num_votes_restart(camera_switch);
+    if(camera_switch == 1 && msg.num >= 0)
+    {
+        num_update(msg.num);
+        if(num_updated_)
+        {
+            updated |= BOARD_NUM_UPDATED;
+        }
+    }
+
+    double weight = mapping_weight(camera_switch);
+    if(weight > 0.0 && !msg.detections.empty())
+    {
+        detection_batch_clear(batch_);
+        for(size_t i = 0; i < msg.detections.size(); ++i)
+        {
+            const state_machine::BoardDetection& detection = msg.detections[i];
+            if(detection.id > BOARD_ID_MAX)
+            {
+                ROS_INFO("board num error!");
+                continue;   /* the others of the frame are still read, no sentinel here. */
+            }
+            double w = weight * detection.confidence * BOARD_DETECTION_CONFIDENCE_SCALE;
+            if(w <= 0.0)
+            {
+                continue;
+            }
+            double r[3];
+            for(int k = 0; k < 3; ++k)
+            {
+                double sigma = detection.sigma[k] * BOARD_DETECTION_SIGMA_SCALE;
+                r[k] = detection.sigma[k] > 0 ? sigma * sigma / w : -1.0;
+            }
+            if(!detection_batch_push(batch_, detection.id,
+                                     detection.x * BOARD_DETECTION_POSITION_SCALE,
+                                     detection.y * BOARD_DETECTION_POSITION_SCALE,
+                                     detection.z * BOARD_DETECTION_POSITION_SCALE, w, r[0], r[1], r[2]))
+            {
+                ingest(current_pos);
+                --i;    /* again in the next batch. */
+            }
+        }
+        ingest(current_pos);
+    }
+    if(!dirty_.empty())
+    {
+        updated |= BOARD_POSITION_UPDATED;
+    }
+    return updated;
+}
+
+void BoardDetector::num_update(int num)
+{
+    num_updated_ = false;
+    if(num == 11)   ROS_INFO("incomplete rectangle detected");
+    else if(num >9 || num <0)
+        {
+            ROS_INFO("board num error!");
+        }
+    else
+    {
+        if(digit_voter_push(voter_, voter_config_, num))
+        {
+            vision_num_ = voter_.decided;
+            num_updated_ = true;
+        }
+    }
+}
+
+void BoardDetector::num_votes_restart(int camera_switch)
+{
+    /* not reading num: the next num is read in front of another board. */
+    if(camera_switch != 1 && (voter_.count > 0 || voter_.decided >= 0))
+    {
+        digit_voter_reset(voter_);
+    }
+}
+
+void BoardDetector::scan_update(const sensor_msgs::LaserScan& scan, const geometry_msgs::Point& current_pos, double weight)
+{
+    int amout = scan.ranges.size()/4;
+    /* get vision current detection message. */
+    detection_batch_clear(batch_);
+    for ( int i = 0; i < amout; ++i )
+    {
+        int num = (int)scan.ranges[i*4];  /* No. of board detected. -libn */
+        if(num == BOARD_NUM_INCOMPLETE)	break;	/* incomplete rectangle detected. -libn */
+        else if(num > BOARD_SCAN_NUM_MAX || num < 0)
+        {
+            ROS_INFO("board num error!");
+            break;
+        }
+        if(!detection_batch_push(batch_, num, scan.ranges[i*4 + 1], scan.ranges[i*4 + 2], scan.ranges[i*4 + 3],
+                                 weight, -1.0, -1.0, -1.0))
+        {
+            ingest(current_pos);
+            --i;    /* again in the next batch. */
+        }
+    }
+    ingest(current_pos);
+}
+
+/* batch_ emptied. */
+void BoardDetector::ingest(const geometry_msgs::Point& current_pos)
+{
+    if(batch_.count == 0)
+    {
+        return;
+    }
+    const double pos[3] = {current_pos.x, current_pos.y, current_pos.z};
+    detection_batch_transform(batch_, pos, estimator_.sigma_measurement, estimator_.range_nominal);
+
+    /* landmarks and their estimates. a board detected twice in the batch is fused again afterwards,
+     * in order, from the estimate updated by the first detection. */
+    batch_serial_++;
+    int again[DETECTION_BATCH_MAX];
+    int again_index[DETECTION_BATCH_MAX];
+    int again_count = 0;
+    for(int i = 0; i < batch_.count; ++i)
+    {
+        int num = batch_.id[i];
+        int index = num >= 0 ? map_.insert(num) : map_.nearest(batch_.z[0][i], batch_.z[1][i], BOARD_ASSOCIATION_RADIUS);
+        batch_.landmark[i] = -1;
+        if(index < 0)
+        {
+            continue;   /* num not read, no board there. */
+        }
+        if(index >= (int)batch_mark_.size())
+        {
+            batch_mark_.resize(map_.size(), 0);
+        }
+        if(batch_mark_[index] == batch_serial_)
+        {
+            again[again_count] = i;
+            again_index[again_count++] = index;
+            continue;
+        }
+        batch_mark_[index] = batch_serial_;
+        batch_.landmark[i] = index;
+        const BoardEstimate& estimate = map_.landmark(index).estimate;
+        for(int a = 0; a < 3; ++a)
+        {
+            batch_.x[a][i] = estimate.initialized ? estimate.x[a] : batch_.z[a][i];
+            batch_.var[a][i] = estimate.initialized ? estimate.var[a] : 0.0;
+        }
+    }
+    for(int i = 0; i < again_count; ++i)
+    {
+        /* gated with the others, gate result not used. */
+        for(int a = 0; a < 3; ++a)
+        {
+            batch_.x[a][again[i]] = batch_.z[a][again[i]];
+            batch_.var[a][again[i]] = 0.0;
+        }
+    }
+    detection_batch_gate(batch_, estimator_.sigma_process * estimator_.sigma_process);
+
+    for(int i = 0; i < batch_.count; ++i)
+    {
+        int index = batch_.landmark[i];
+        if(index < 0)
+        {
+            continue;
+        }
+        const double z[3] = {batch_.z[0][i], batch_.z[1][i], batch_.z[2][i]};
+        const double r[3] = {batch_.r[0][i], batch_.r[1][i], batch_.r[2][i]};
+        const double var[3] = {batch_.var[0][i], batch_.var[1][i], batch_.var[2][i]};
+        const double k[3] = {batch_.k[0][i], batch_.k[1][i], batch_.k[2][i]};
+        if(board_estimate_apply(map_.estimate(index), estimator_, z, r, var, k, batch_.d2[i]) == BOARD_ESTIMATE_RESET)
+        {
+            ROS_INFO("board %d: %d detections out of gate, estimate restarted", map_.landmark(index).id, estimator_.reject_reset);
+        }
+        map_.moved(index);
+        publish(index);
+    }
+    for(int i = 0; i < again_count; ++i)
+    {
+        int index = again_index[i];
+        const double z[3] = {batch_.z[0][again[i]], batch_.z[1][again[i]], batch_.z[2][again[i]]};
+        const double r[3] = {batch_.r[0][again[i]], batch_.r[1][again[i]], batch_.r[2][again[i]]};
+        if(board_estimate_fuse(map_.estimate(index), estimator_, z, r) == BOARD_ESTIMATE_RESET)
+        {
+            ROS_INFO("board %d: %d detections out of gate, estimate restarted", map_.landmark(index).id, estimator_.reject_reset);
+        }
+        map_.moved(index);
+        publish(index);
+    }
+    detection_batch_clear(batch_);
+}
+
+void BoardDetector::publish(int index)
+{
+    const BoardEstimate& estimate = map_.landmark(index).estimate;
+    /* publish only usable estimates: a restarted board keeps its last one until usable again. */
+    if(board_estimate_usable(estimate, estimator_))
+    {
+        if(index >= (int)published_.size())
+        {
+            published_.resize(index + 1, -1);
+        }
+        int entry = published_[index];
+        if(entry < 0)
+        {
+            entry = published_[index] = (int)board10_pub_.drawingboard.size();
+            board10_pub_.drawingboard.push_back(state_machine::DrawingBoard());
+            board10_pub_.drawingboard.back().version = 0;
+            board10_pub_.drawingboard.back().valid = false;
+            dirty_mark_.push_back(false);
+        }
+        state_machine::DrawingBoard& board = board10_pub_.drawingboard[entry];
+        double sigma = board_estimate_sigma(estimate);
+        if(board.valid &&
+           fabs(board.x - estimate.x[0]) < BOARD_PUBLISH_EPSILON &&
+           fabs(board.y - estimate.x[1]) < BOARD_PUBLISH_EPSILON &&
+           fabs(board.z - estimate.x[2]) < BOARD_PUBLISH_EPSILON &&
+           fabs(board.sigma - sigma) < BOARD_PUBLISH_EPSILON)
+        {
+            return;     /* published value still holds. */
+        }
+        board.num = map_.landmark(index).id;
+        board.x = estimate.x[0];
+        board.y = estimate.x[1];
+        board.z = estimate.x[2];
+        board.sigma = sigma;
+        board.valid = true;
+        board.version++;
+        if(!dirty_mark_[entry])
+        {
+            dirty_mark_[entry] = true;
+            dirty_.push_back(entry);
+        }
+    }
+}
+
+void BoardDetector::delta(state_machine::BoardMapDelta& msg, bool keyframe)
+{
+    msg.seq = ++delta_seq_;
+    msg.keyframe = keyframe;
+    msg.boards.clear();
+    if(keyframe)
+    {
+        msg.boards = board10_pub_.drawingboard;
+    }
+    else
+    {
+        for(size_t i = 0; i < dirty_.size(); ++i)
+        {
+            msg.boards.push_back(board10_pub_.drawingboard[dirty_[i]]);
+        }
+    }
+    for(size_t i = 0; i < dirty_.size(); ++i)
+    {
+        dirty_mark_[dirty_[i]] = false;
+    }
+    dirty_.clear();
+}
@@ -0,0 +1,138 @@
+/**
+* @file     : board_estimator.cpp
+* @brief    : recursive board position estimator: per-board Kalman filter and outlier gating.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/board_estimator.h>
+
+#include <math.h>
+
+BoardEstimatorConfig board_estimator_default_config()
+{
+    BoardEstimatorConfig config;
+    config.sigma_measurement = BOARD_SIGMA_MEASUREMENT;
+    config.range_nominal = BOARD_RANGE_NOMINAL;
+    config.sigma_process = BOARD_SIGMA_PROCESS;
+    config.sigma_usable = BOARD_SIGMA_USABLE;
+    config.gate = BOARD_GATE;
+    config.reject_reset = BOARD_REJECT_RESET;
+    return config;
+}
+
+void board_estimate_reset(BoardEstimate& estimate)
+{
+    estimate.initialized = false;
+    for(int i = 0; i < 3; ++i)
+    {
+        estimate.x[i] = 0.0;
+        estimate.var[i] = 0.0;
+    }
+    estimate.updates = 0;
+    estimate.rejected = 0;
+    estimate.outliers = 0;
+}
+
+/* grows with range(not below a quarter of nominal), divided by the weight. */
+double board_measurement_var(const BoardEstimatorConfig& config, double range, double weight)
+{
+    double sigma = config.sigma_measurement * fmax(range / config.range_nominal, 0.25);
+    return sigma * sigma / fmax(weight, 1e-3);
+}
+
+static void init(BoardEstimate& estimate, const double z[3], const double r[3])
+{
+    for(int i = 0; i < 3; ++i)
+    {
+        estimate.x[i] = z[i];
+        estimate.var[i] = r[i];
+    }
+    estimate.initialized = true;
+    estimate.updates = 1;
+    estimate.rejected = 0;
+}
+
+BoardEstimateResult board_estimate_fuse(BoardEstimate& estimate, const BoardEstimatorConfig& config,
+                                        const double z[3], const double r[3])
+{
+    if(!estimate.initialized)
+    {
+        init(estimate, z, r);
+        return BOARD_ESTIMATE_INIT;
+    }
+
+    /* predict: constant position, drift. */
+    double q = config.sigma_process * config.sigma_process;
+    double var[3];
+    double k[3];    /* gain: var / innovation variance. */
+    double d2 = 0.0;
+    for(int i = 0; i < 3; ++i)
+    {
+        var[i] = estimate.var[i] + q;
+        double s_inv = 1.0 / (var[i] + r[i]);
+        double innovation = z[i] - estimate.x[i];
+        d2 += innovation * innovation * s_inv;
+        k[i] = var[i] * s_inv;
+    }
+    return board_estimate_apply(estimate, config, z, r, var, k, d2);
+}
+
+BoardEstimateResult board_estimate_apply(BoardEstimate& estimate, const BoardEstimatorConfig& config,
+                                         const double z[3], const double r[3],
+                                         const double var[3], const double k[3], double d2)
+{
+    if(!estimate.initialized)
+    {
+        init(estimate, z, r);
+        return BOARD_ESTIMATE_INIT;
+    }
+    for(int i = 0; i < 3; ++i)
+    {
+        estimate.var[i] = var[i];   /* predicted: kept by an outlier as well. */
+    }
+
+    if(d2 > config.gate)
+    {
+        estimate.outliers++;
+        if(++estimate.rejected >= config.reject_reset)
+        {
+            init(estimate, z, r);   /* board(or its first detections) elsewhere. */
+            return BOARD_ESTIMATE_RESET;
+        }
+        return BOARD_ESTIMATE_REJECTED;
+    }
+
+    /* update: H = I, covariance stays diagonal. */
+    for(int i = 0; i < 3; ++i)
+    {
+        estimate.x[i] += k[i] * (z[i] - estimate.x[i]);
+        estimate.var[i] *= 1.0 - k[i];
+    }
+    estimate.updates++;
+    estimate.rejected = 0;
+    return BOARD_ESTIMATE_UPDATED;
+}
+
+BoardEstimateResult board_estimate_update(BoardEstimate& estimate, const BoardEstimatorConfig& config,
+                                          const double z[3], double range, double weight)
+{
+    double v = board_measurement_var(config, range, weight);
+    double r[3] = {v, v, v};
+    return board_estimate_fuse(estimate, config, z, r);
+}
+
+double board_estimate_sigma(const BoardEstimate& estimate)
+{
+    if(!estimate.initialized)
+    {
+        return -1.0;
+    }
+    return sqrt(fmax(estimate.var[0], fmax(estimate.var[1], estimate.var[2])));
+}
+
+bool board_estimate_usable(const BoardEstimate& estimate, const BoardEstimatorConfig& config)
+{
+    double usable = config.sigma_usable * config.sigma_usable;
+    return estimate.initialized && estimate.var[0] < usable && estimate.var[1] < usable && estimate.var[2] < usable;
+}
@@ -0,0 +1,131 @@
+/**
+* @file     : board_map.cpp
+* @brief    : board map: landmarks by id and by grid cell.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/board_map.h>
+
+#include <algorithm>
+#include <math.h>
+
+static const long long CELL_NONE = 0x7fffffffffffffffLL;   /* not initialized: not in the grid(cell x INT_MAX). */
+static const int CELL_LIMIT = 1 << 30;                      /* cells clamped to +-CELL_LIMIT. */
+
+BoardMap::BoardMap(double cell)
+    : cell_(cell)
+{
+}
+
+void BoardMap::clear(void)
+{
+    landmarks_.clear();
+    index_.clear();
+    grid_.clear();
+}
+
+int BoardMap::find(int id) const
+{
+    std::map<int, int>::const_iterator it = index_.find(id);
+    return it == index_.end() ? -1 : it->second;
+}
+
+int BoardMap::insert(int id)
+{
+    int index = find(id);
+    if(index >= 0)
+    {
+        return index;
+    }
+    BoardLandmark landmark;
+    landmark.id = id;
+    board_estimate_reset(landmark.estimate);
+    landmark.cell = CELL_NONE;
+    landmarks_.push_back(landmark);
+    index = (int)landmarks_.size() - 1;
+    index_[id] = index;
+    return index;
+}
+
+int BoardMap::cell_of(double v) const
+{
+    /* clamped: no overflow of int, a cell x of INT_MAX(CELL_NONE) never made. */
+    double c = floor(v / cell_);
+    if(!(c > -CELL_LIMIT))  return -CELL_LIMIT;     /* NaN too. */
+    if(c > CELL_LIMIT)      return CELL_LIMIT;
+    return (int)c;
+}
+
+long long BoardMap::key(int cx, int cy) const
+{
+    /* unsigned: cells are negative left of and below the origin. */
+    return (long long)(((unsigned long long)(unsigned)cx << 32) | (unsigned)cy);
+}
+
+void BoardMap::moved(int index)
+{
+    BoardLandmark& landmark = landmarks_[index];
+    long long cell = CELL_NONE;
+    if(landmark.estimate.initialized)
+    {
+        cell = key(cell_of(landmark.estimate.x[0]), cell_of(landmark.estimate.x[1]));
+    }
+    if(cell == landmark.cell)
+    {
+        return;
+    }
+    if(landmark.cell != CELL_NONE)
+    {
+        std::unordered_map<long long, std::vector<int> >::iterator old = grid_.find(landmark.cell);
+        if(old != grid_.end())
+        {
+            std::vector<int>& members = old->second;
+            std::vector<int>::iterator member = std::find(members.begin(), members.end(), index);
+            if(member != members.end())
+            {
+                members.erase(member);
+            }
+            if(members.empty())
+            {
+                grid_.erase(old);   /* the grid holds occupied cells only. */
+            }
+        }
+    }
+    if(cell != CELL_NONE)
+    {
+        grid_[cell].push_back(index);
+    }
+    landmark.cell = cell;
+}
+
+int BoardMap::nearest(double x, double y, double max_distance) const
+{
+    const int cx = cell_of(x), cy = cell_of(y);
+    const int r = (int)ceil(max_distance / cell_);
+    int best = -1;
+    double best_d2 = max_distance * max_distance;
+    for(int i = cx - r; i <= cx + r; ++i)
+    {
+        for(int j = cy - r; j <= cy + r; ++j)
+        {
+            std::unordered_map<long long, std::vector<int> >::const_iterator cell = grid_.find(key(i, j));
+            if(cell == grid_.end())
+            {
+                continue;
+            }
+            for(size_t k = 0; k < cell->second.size(); ++k)
+            {
+                const BoardEstimate& estimate = landmarks_[cell->second[k]].estimate;
+                double dx = estimate.x[0] - x, dy = estimate.x[1] - y;
+                double d2 = dx*dx + dy*dy;
+                if(d2 <= best_d2)
+                {
+                    best_d2 = d2;
+                    best = cell->second[k];
+                }
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,96 @@
+/**
+* @file     : board_mirror.cpp
+* @brief    : consumer side of BoardMapDelta: versioned board entries, sequence gaps, keyframes.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/board_mirror.h>
+
+void board_mirror_reset(BoardMirror& mirror)
+{
+    mirror.seq = 0;
+    mirror.lost = 0;
+    for(int i = 0; i < BOARD_NUM_MAX; ++i)
+    {
+        mirror.boards.board[i].x = 0.0f;
+        mirror.boards.board[i].y = 0.0f;
+        mirror.boards.board[i].z = 0.0f;
+        mirror.boards.board[i].valid = false;
+        mirror.boards.board[i].version = 0;
+    }
+    mirror.boards.epoch = 0;
+}
+
+unsigned board_mirror_apply(BoardMirror& mirror, const state_machine::BoardMapDelta& msg)
+{
+    /* first message: not a loss. messages lost, or a publisher restarted(seq and versions from 1 again):
+     * versions held are no longer comparable, forgotten so that every entry received is applied.
+     * positions are kept until replaced(or dropped by the next keyframe). */
+    bool lost = mirror.seq != 0 && msg.seq > mirror.seq + 1;
+    if(lost)
+    {
+        mirror.lost += msg.seq - mirror.seq - 1;
+    }
+    if(lost || msg.seq <= mirror.seq)
+    {
+        for(int i = 0; i < BOARD_NUM_MAX; ++i)
+        {
+            mirror.boards.board[i].version = 0;
+        }
+        mirror.boards.epoch++;  /* versions copied by the mission no longer comparable either. */
+    }
+    mirror.seq = msg.seq;
+
+    unsigned changed = 0;
+    unsigned held = 0;
+    for(size_t i = 0; i < msg.boards.size(); ++i)
+    {
+        const state_machine::DrawingBoard& entry = msg.boards[i];
+        if(entry.num < 0 || entry.num >= BOARD_NUM_MAX)
+        {
+            continue;
+        }
+        held |= 1u << entry.num;
+        BoardSnapshot& board = mirror.boards.board[entry.num];
+        if(entry.version == board.version && board.version != 0)
+        {
+            continue;   /* keyframe: unchanged. */
+        }
+        board.x = entry.x;
+        board.y = entry.y;
+        board.z = entry.z;
+        board.valid = entry.valid;
+        board.version = entry.version;
+        changed |= 1u << entry.num;
+    }
+    if(msg.keyframe)
+    {
+        for(int i = 0; i < BOARD_NUM_MAX; ++i)
+        {
+            if(!(held & (1u << i)) && mirror.boards.board[i].valid)
+            {
+                mirror.boards.board[i].valid = false;
+                mirror.boards.board[i].version = 0;
+                changed |= 1u << i;
+            }
+        }
+    }
+    return changed;
+}
+
+unsigned board_mirror_copy(const BoardSnapshots& boards, BoardSnapshot* board, uint32_t& epoch)
+{
+    bool resync = boards.epoch != epoch;
+    epoch = boards.epoch;
+    unsigned copied = 0;
+    for(int i = 0; i < BOARD_NUM_MAX; ++i)
+    {
+        if(resync || boards.board[i].version == 0 || boards.board[i].version != board[i].version)
+        {
+            board[i] = boards.board[i];
+            copied |= 1u << i;
+        }
+    }
+    return copied;
+}
@@ -0,0 +1,218 @@
+/**
+* @file     : command_executor.cpp
+* @brief    : mavros service calls(set_mode, arming, land) on a worker thread.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/command_executor.h>
+
+CommandOptions command_default_options()
+{
+    CommandOptions options;
+    options.max_attempts = 3;
+    options.timeout = 2.0;
+    options.retry_delay = 0.5;
+    return options;
+}
+
+const char* command_status_name(CommandStatus status)
+{
+    switch(status)
+    {
+        case COMMAND_SUCCESS:       return "success";
+        case COMMAND_REJECTED:      return "rejected";
+        case COMMAND_UNAVAILABLE:   return "unavailable";
+        case COMMAND_TIMEOUT:       return "timeout";
+        case COMMAND_DROPPED:       return "dropped";
+    }
+    return "unknown";
+}
+
+static double seconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+CommandExecutor::CommandExecutor()
+    : stopping_(false)
+{
+    worker_ = std::thread(&CommandExecutor::run, this);
+}
+
+CommandExecutor::~CommandExecutor()
+{
+    stop();
+}
+
+void CommandExecutor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    if(worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+std::future<CommandResult> CommandExecutor::push(const std::string& name, const ros::ServiceClient& client,
+                                                 const std::function<CallStatus()>& call, const CommandOptions& options)
+{
+    std::unique_ptr<Command> command(new Command);
+    command->name = name;
+    command->client = client;
+    command->call = call;
+    command->options = options;
+    command->submitted = Clock::now();
+    std::future<CommandResult> result = command->result.get_future();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if(stopping_)
+    {
+        lock.unlock();
+        CommandResult dropped = {COMMAND_DROPPED, 0, 0.0};
+        command->result.set_value(dropped);
+        return result;
+    }
+    queue_.push_back(std::move(command));
+    lock.unlock();
+    wakeup_.notify_one();
+    return result;
+}
+
+void CommandExecutor::run()
+{
+    for(;;)
+    {
+        std::unique_ptr<Command> command;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while(!stopping_ && queue_.empty())
+            {
+                wakeup_.wait(lock);
+            }
+            if(stopping_)
+            {
+                break;
+            }
+            command = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        command->result.set_value(execute(*command));
+    }
+
+    /* commands not run yet. */
+    std::lock_guard<std::mutex> lock(mutex_);
+    while(!queue_.empty())
+    {
+        CommandResult dropped = {COMMAND_DROPPED, 0, 0.0};
+        queue_.front()->result.set_value(dropped);
+        queue_.pop_front();
+    }
+}
+
+CommandResult CommandExecutor::execute(Command& command)
+{
+    const Clock::time_point deadline = command.submitted
+        + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(command.options.timeout));
+    CommandResult result = {COMMAND_TIMEOUT, 0, 0.0};
+
+    while(result.attempts < command.options.max_attempts)
+    {
+        Clock::time_point now = Clock::now();
+        if(now >= deadline)
+        {
+            result.status = COMMAND_TIMEOUT;
+            break;
+        }
+
+        /* bounded wait for mavros to advertise the service, the call itself cannot be interrupted:
+         * a call hanging in mavros holds this thread only. */
+        result.attempts++;
+        CallStatus status = CALL_FAILED;
+        Clock::time_point start = Clock::now();
+        if(command.client.waitForExistence(ros::Duration(seconds(deadline - now))))
+        {
+            status = command.call();
+        }
+        record(command.name, status, seconds(Clock::now() - start));
+
+        if(status == CALL_SUCCESS)
+        {
+            result.status = COMMAND_SUCCESS;
+            break;
+        }
+        result.status = status == CALL_REJECTED ? COMMAND_REJECTED : COMMAND_UNAVAILABLE;
+
+        if(result.attempts < command.options.max_attempts)
+        {
+            /* retry delay, cut short by stop(). */
+            std::unique_lock<std::mutex> lock(mutex_);
+            Clock::time_point retry = Clock::now()
+                + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(command.options.retry_delay));
+            if(wakeup_.wait_until(lock, retry, [this]() { return stopping_; }))
+            {
+                break;
+            }
+        }
+    }
+
+    if(result.status != COMMAND_SUCCESS && Clock::now() >= deadline)
+    {
+        result.status = COMMAND_TIMEOUT;
+    }
+    if(result.status == COMMAND_TIMEOUT)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metrics_[command.name].timeouts++;
+    }
+    result.latency = seconds(Clock::now() - command.submitted);
+    return result;
+}
+
+void CommandExecutor::record(const std::string& name, CallStatus status, double rtt)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    CommandMetrics& m = metrics_[name];
+    m.calls++;
+    switch(status)
+    {
+        case CALL_SUCCESS:  m.successes++;      break;
+        case CALL_REJECTED: m.rejected++;       break;
+        case CALL_FAILED:   m.unavailable++;    break;
+    }
+    m.rtt_last = rtt;
+    m.rtt_total += rtt;
+    if(rtt > m.rtt_max)
+    {
+        m.rtt_max = rtt;
+    }
+}
+
+CommandMetrics CommandExecutor::metrics(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, CommandMetrics>::const_iterator it = metrics_.find(name);
+    if(it == metrics_.end())
+    {
+        CommandMetrics empty = CommandMetrics();
+        return empty;
+    }
+    return it->second;
+}
+
+void CommandExecutor::report() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(std::map<std::string, CommandMetrics>::const_iterator it = metrics_.begin(); it != metrics_.end(); ++it)
+    {
+        const CommandMetrics& m = it->second;
+        ROS_INFO("service %s: calls %u success %u rejected %u unavailable %u timeouts %u "
+                 "rtt last %.1f ms mean %.1f ms max %.1f ms",
+                 it->first.c_str(), m.calls, m.successes, m.rejected, m.unavailable, m.timeouts,
+                 m.rtt_last * 1e3, m.calls ? m.rtt_total / m.calls * 1e3 : 0.0, m.rtt_max * 1e3);
+    }
+}
@@ -0,0 +1,139 @@
+/**
+* @file     : detection_batch.cpp
+* @brief    : batch ingest kernel of BoardDetector: transform and gating, SIMD with scalar tail.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/detection_batch.h>
+
+#include <math.h>
+
+/* unaligned loads: a BoardDetector(and its batch) may be heap allocated without 32 byte alignment. */
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LANES 4
+typedef __m256d vec;
+#define vload(p)        _mm256_loadu_pd(p)
+#define vstore(p, a)    _mm256_storeu_pd(p, a)
+#define vset1(a)        _mm256_set1_pd(a)
+#define vadd(a, b)      _mm256_add_pd(a, b)
+#define vsub(a, b)      _mm256_sub_pd(a, b)
+#define vmul(a, b)      _mm256_mul_pd(a, b)
+#define vdiv(a, b)      _mm256_div_pd(a, b)
+#define vmax(a, b)      _mm256_max_pd(a, b)
+#define vselect_neg(c, a, b)    _mm256_blendv_pd(b, a, _mm256_cmp_pd(c, _mm256_setzero_pd(), _CMP_LT_OQ))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LANES 2
+typedef __m128d vec;
+#define vload(p)        _mm_loadu_pd(p)
+#define vstore(p, a)    _mm_storeu_pd(p, a)
+#define vset1(a)        _mm_set1_pd(a)
+#define vadd(a, b)      _mm_add_pd(a, b)
+#define vsub(a, b)      _mm_sub_pd(a, b)
+#define vmul(a, b)      _mm_mul_pd(a, b)
+#define vdiv(a, b)      _mm_div_pd(a, b)
+#define vmax(a, b)      _mm_max_pd(a, b)
+static inline vec vselect_neg(vec c, vec a, vec b)     /* c < 0 ? a : b, no blendv before SSE4.1. */
+{
+    vec mask = _mm_cmplt_pd(c, _mm_setzero_pd());
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+#else
+#define LANES 1
+#endif
+
+const char* detection_batch_isa(void)
+{
+#if defined(__AVX__)
+    return "avx";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+static void transform_scalar(DetectionBatch& batch, int i, const double pos[3], double sm2, double inv_rn2)
+{
+    double range2 = 0.0;
+    for(int a = 0; a < 3; ++a)
+    {
+        batch.z[a][i] = batch.d[a][i] + pos[a];
+        range2 += batch.d[a][i] * batch.d[a][i];
+    }
+    double model = sm2 * fmax(range2 * inv_rn2, 0.0625) / fmax(batch.w[i], 1e-3);
+    for(int a = 0; a < 3; ++a)
+    {
+        if(batch.r[a][i] < 0.0)
+        {
+            batch.r[a][i] = model;
+        }
+    }
+}
+
+void detection_batch_transform(DetectionBatch& batch, const double pos[3], double sigma_measurement, double range_nominal)
+{
+    const double sm2 = sigma_measurement * sigma_measurement;
+    const double inv_rn2 = 1.0 / (range_nominal * range_nominal);
+    int i = 0;
+#if LANES > 1
+    const vec p0 = vset1(pos[0]), p1 = vset1(pos[1]), p2 = vset1(pos[2]);
+    const vec vsm2 = vset1(sm2), vinv_rn2 = vset1(inv_rn2), vmin_scale = vset1(0.0625), vmin_w = vset1(1e-3);
+    for(; i + LANES <= batch.count; i += LANES)
+    {
+        vec d0 = vload(&batch.d[0][i]), d1 = vload(&batch.d[1][i]), d2 = vload(&batch.d[2][i]);
+        vstore(&batch.z[0][i], vadd(d0, p0));
+        vstore(&batch.z[1][i], vadd(d1, p1));
+        vstore(&batch.z[2][i], vadd(d2, p2));
+        vec range2 = vadd(vadd(vmul(d0, d0), vmul(d1, d1)), vmul(d2, d2));
+        vec model = vdiv(vmul(vsm2, vmax(vmul(range2, vinv_rn2), vmin_scale)), vmax(vload(&batch.w[i]), vmin_w));
+        for(int a = 0; a < 3; ++a)
+        {
+            vec r = vload(&batch.r[a][i]);
+            vstore(&batch.r[a][i], vselect_neg(r, model, r));
+        }
+    }
+#endif
+    for(; i < batch.count; ++i)
+    {
+        transform_scalar(batch, i, pos, sm2, inv_rn2);
+    }
+}
+
+void detection_batch_gate(DetectionBatch& batch, double q)
+{
+    int i = 0;
+#if LANES > 1
+    const vec vq = vset1(q), one = vset1(1.0);
+    for(; i + LANES <= batch.count; i += LANES)
+    {
+        vec d2 = vset1(0.0);
+        for(int a = 0; a < 3; ++a)
+        {
+            vec var = vadd(vload(&batch.var[a][i]), vq);
+            vec s_inv = vdiv(one, vadd(var, vload(&batch.r[a][i])));
+            vec e = vsub(vload(&batch.z[a][i]), vload(&batch.x[a][i]));
+            vstore(&batch.var[a][i], var);
+            vstore(&batch.k[a][i], vmul(var, s_inv));
+            d2 = vadd(d2, vmul(vmul(e, e), s_inv));
+        }
+        vstore(&batch.d2[i], d2);
+    }
+#endif
+    for(; i < batch.count; ++i)
+    {
+        double d2 = 0.0;
+        for(int a = 0; a < 3; ++a)
+        {
+            double var = batch.var[a][i] + q;
+            double s_inv = 1.0 / (var + batch.r[a][i]);
+            double e = batch.z[a][i] - batch.x[a][i];
+            batch.var[a][i] = var;
+            batch.k[a][i] = var * s_inv;
+            d2 += e * e * s_inv;
+        }
+        batch.d2[i] = d2;
+    }
+}
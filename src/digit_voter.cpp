@@ -0,0 +1,93 @@
+/**
+* @file     : digit_voter.cpp
+* @brief    : board num voting: sliding window histogram, decided on posterior confidence.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/digit_voter.h>
+
+DigitVoterConfig digit_voter_default_config(void)
+{
+    DigitVoterConfig config;
+    config.window = DIGIT_VOTE_WINDOW;
+    config.confidence = DIGIT_VOTE_CONFIDENCE;
+    config.misread = DIGIT_VOTE_MISREAD;
+    config.min_votes = DIGIT_VOTE_MIN_VOTES;
+    return config;
+}
+
+void digit_voter_reset(DigitVoter& voter)
+{
+    voter.head = 0;
+    voter.count = 0;
+    for(int d = 0; d < DIGIT_VOTE_DIGITS; ++d)
+    {
+        voter.votes[d] = 0;
+    }
+    voter.leader = -1;
+    voter.confidence = 0.0;
+    voter.decided = -1;
+}
+
+static int window_size(const DigitVoterConfig& config)
+{
+    if(config.window < 1)                       return 1;
+    if(config.window > DIGIT_VOTE_WINDOW_MAX)   return DIGIT_VOTE_WINDOW_MAX;
+    return config.window;
+}
+
+bool digit_voter_push(DigitVoter& voter, const DigitVoterConfig& config, int digit)
+{
+    if(digit < 0 || digit >= DIGIT_VOTE_DIGITS)
+    {
+        return false;
+    }
+    const int window = window_size(config);
+    while(voter.count >= window)    /* window may have been shrunk since the last read. */
+    {
+        voter.votes[voter.read[(voter.head - voter.count + DIGIT_VOTE_WINDOW_MAX) % DIGIT_VOTE_WINDOW_MAX]]--;
+        voter.count--;
+    }
+    voter.read[voter.head] = digit;
+    voter.head = (voter.head + 1) % DIGIT_VOTE_WINDOW_MAX;
+    voter.count++;
+    voter.votes[digit]++;
+
+    /* leader kept on a tie. */
+    if(voter.leader < 0)
+    {
+        voter.leader = digit;
+    }
+    for(int d = 0; d < DIGIT_VOTE_DIGITS; ++d)
+    {
+        if(voter.votes[d] > voter.votes[voter.leader])
+        {
+            voter.leader = d;
+        }
+    }
+
+    double misread = config.misread < 1e-6 ? 1e-6 : (config.misread > 0.9 ? 0.9 : config.misread);
+    double rho = misread / ((DIGIT_VOTE_DIGITS - 1) * (1.0 - misread));
+    double power[DIGIT_VOTE_WINDOW_MAX + 1];   /* rho^margin, no pow() per digit. */
+    const int top = voter.votes[voter.leader];
+    power[0] = 1.0;
+    for(int k = 1; k <= top; ++k)
+    {
+        power[k] = power[k - 1] * rho;
+    }
+    double sum = 0.0;
+    for(int d = 0; d < DIGIT_VOTE_DIGITS; ++d)
+    {
+        sum += power[top - voter.votes[d]];
+    }
+    voter.confidence = 1.0 / sum;
+
+    if(voter.leader != voter.decided && voter.votes[voter.leader] >= config.min_votes &&
+       voter.confidence >= config.confidence)
+    {
+        voter.decided = voter.leader;
+        return true;
+    }
+    return false;
+}
@@ -9,19 +9,31 @@
 #include <sensor_msgs/LaserScan.h>
 #include <state_machine/DrawingBoard.h>
 #include <state_machine/DrawingBoard10.h>
+#include <state_machine/BoardDetections.h>
+#include <state_machine/DigitVote.h>
+#include <state_machine/BoardMapDelta.h>
+#include <state_machine/board_detector.h>
+#include <state_machine/pose_history.h>
 #include <geometry_msgs/PoseStamped.h>
 
 #include <std_msgs/Int32.h>
 
 ros::Publisher DrawingBoard_Position_pub;
+ros::Publisher board_delta_pub;
+state_machine::BoardMapDelta board_delta_data;
+double board_keyframe_period = 1.0;     /* all boards resent(s), 0: every frame. */
+ros::Time last_keyframe;
 
 ros::Time last_request;
 
 // local position msg callback function
 geometry_msgs::PoseStamped current_pos;
+PoseHistory pose_history;       /* detections are placed with the pose at capture time. */
+double vision_delay = 0.0;      /* capture -> header stamp of the vision message(s). */
 void pos_cb(const geometry_msgs::PoseStamped::ConstPtr& msg)
 {
     current_pos = *msg;
+    pose_history_push(pose_history, msg->header.stamp, msg->pose.position);
 }
 
 std_msgs::Int32 camera_switch_data;
@@ -32,143 +44,86 @@ void camera_switch_cb(const std_msgs::Int32::ConstPtr& msg)
 }
 
 /* send indexed setpoint. -libn <Aug 15, 2016 9:00:02 AM> */
-state_machine::DrawingBoard board;
-state_machine::DrawingBoard10 board10;  /* current board10 */
-state_machine::DrawingBoard10 board10_last; /* last board10 */
-state_machine::DrawingBoard10 board10_pub; /* board10 for publish */
+BoardDetector board_detector;   /* stable num and board positions from vision. */
 
 sensor_msgs::LaserScan board_scan;
 std_msgs::Int32 vision_num_data;
-std_msgs::Int32 vision_num_data_last;
-#define MIN_OBSERVE_TIMES 4 /* 5 times. */
-#define MIN_DETECTION_TIMES_FAR 4  /* count_num > MIN_DETECTION_TIMES => num detected; else: num not detected. */
-#define MIN_DETECTION_TIMES_NEAR 2
-#define MAX_DETECTION_DISTANCE 0.5  /* max detected board distance between different loops. */
-
-
-int count_num = 0;
-int count_detection[10] = {0,0,0,0,0,0,0,0,0,0};
 
 ros::Publisher  vision_num_pub;
-void board_pos_cb(const sensor_msgs::LaserScan::ConstPtr& msg)
-{
-	board_scan = *msg;
-    int num;
-
-//    ROS_INFO("vision message received!");
+state_machine::DigitVote vision_num_vote_data;
+ros::Publisher  vision_num_vote_pub;
+double num_republish_period = 0.5;  /* decided num resent while reading num(s), 0: every frame. */
+ros::Time last_num_publish;
 
-    /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-    if(camera_switch_data.data == 1 && board_scan.ranges[1] > 100 && board_scan.ranges[2] > 100)
+/* pose at capture time: latest pose if the message has no stamp. */
+geometry_msgs::Point capture_position(const ros::Time& stamp)
+{
+    geometry_msgs::Point capture_pos = current_pos.pose.position;
+    ros::Time capture = stamp;
+    if(!capture.isZero())
     {
-        num = (int)board_scan.ranges[0];
-        if(num == 11)   ROS_INFO("incomplete rectangle detected");
-        else if(num >9 || num <0)
-            {
-                ROS_INFO("board num error!");
-            }
-        else
-        {
-            vision_num_data.data = (int)num;
-            if(vision_num_data_last.data == vision_num_data.data)   count_num++;
-            else    count_num = 0;
-            vision_num_data_last = vision_num_data;
-            if(count_num >= MIN_OBSERVE_TIMES)    /* get the same num for MIN_DETECTION_TIMES times at last. */
-            {
-                vision_num_pub.publish(vision_num_data);
-//                ROS_INFO("vision_num_data = %d",vision_num_data.data);
-                count_num = 0;
-            }
-        }
-
+        capture = capture - ros::Duration(vision_delay);
     }
+    pose_history_at(pose_history, capture, capture_pos);
+    return capture_pos;
+}
 
-    if(camera_switch_data.data == 2 && board_scan.ranges[1] < 100 && board_scan.ranges[2] < 100)
+void board_publish(unsigned updated)
+{
+    ros::Time now = ros::Time::now();
+    const DigitVoter& voter = board_detector.voter();
+    if(updated & BOARD_NUM_UPDATED)
+    {
+        vision_num_vote_data.num = board_detector.num();
+        vision_num_vote_data.confidence = voter.confidence;
+        vision_num_vote_data.votes = voter.votes[voter.decided];
+        vision_num_vote_data.window = voter.count;
+        vision_num_data.data = board_detector.num();
+    }
+    /* decision resent at a low rate while reading num(camera_switch 1): a lost message is not final. */
+    bool republish = camera_switch_data.data == 1 && voter.decided >= 0 &&
+                     (now - last_num_publish).toSec() >= num_republish_period;
+    if((updated & BOARD_NUM_UPDATED) || republish)
+    {
+        last_num_publish = now;
+        vision_num_vote_data.header.stamp = now;
+        vision_num_vote_pub.publish(vision_num_vote_data);
+        vision_num_pub.publish(vision_num_data);
+//        ROS_INFO("vision_num_data = %d",vision_num_data.data);
+    }
+    /* boards changed since the last message(keyframe: all of them, periodically). */
+    bool keyframe = (now - last_keyframe).toSec() >= board_keyframe_period;
+    if((updated & BOARD_POSITION_UPDATED) || keyframe)
     {
-        int amout = board_scan.ranges.size()/4;
-        /* get vision current detection message. */
-        for ( int i = 0; i < amout; ++i )
+        board_delta_data.header.stamp = now;
+        board_detector.delta(board_delta_data, keyframe);
+        board_delta_pub.publish(board_delta_data);
+        if(keyframe)
         {
-            num = (int)board_scan.ranges[i*4];  /* No. of board detected. -libn */
-            if(num == 11)	break;	/* incomplete rectangle detected. -libn */
-            else if(num >9 || num <0)
-            {
-                ROS_INFO("board num error!");
-                break;
-            }
-
-    //        ROS_INFO("data received:\n"
-    //            		"num = %d "
-    //            		"x = %f "
-    //            		"y = %f "
-    //            		"z = %f",
-    //					num,board_scan.ranges[i*4 + 1],board_scan.ranges[i*4 + 1],board_scan.ranges[i*4 + 1]);
-
-            board10.drawingboard[num].num = num;
-            board10.drawingboard[num].x = board_scan.ranges[i*4 + 1] + current_pos.pose.position.x;
-            board10.drawingboard[num].y = board_scan.ranges[i*4 + 2] + current_pos.pose.position.y;
-            board10.drawingboard[num].z = board_scan.ranges[i*4 + 3] + current_pos.pose.position.z;
-            board10.drawingboard[num].valid = true;
-
-            /* get the same position for MIN_DETECTION_TIMES times at last. */
-            if(fabs(board10.drawingboard[num].x - board10_last.drawingboard[num].x) < MAX_DETECTION_DISTANCE
-                 && fabs(board10.drawingboard[num].y - board10_last.drawingboard[num].y) < MAX_DETECTION_DISTANCE)
-            {
-                count_detection[num]++;
-            }
-            else    count_detection[num] = 0;
-            float distance = sqrt(board10.drawingboard[num].x*board10.drawingboard[num].x+board10.drawingboard[num].y*board10.drawingboard[num].y);
-            if(distance >4)
-            {
-                if(count_detection[num] >= MIN_DETECTION_TIMES_FAR)
-                {
-                    /* store only stable vision message. */
-                    board10_pub.drawingboard[num] = board10.drawingboard[num];
-                    count_detection[num] = 0;
-                }
-            }
-            else
-            {
-                if(count_detection[num] >= MIN_DETECTION_TIMES_NEAR)
-                {
-                    /* store only stable vision message. */
-                    board10_pub.drawingboard[num] = board10.drawingboard[num];
-                    count_detection[num] = 0;
-                }
-            }
-
-
+            last_keyframe = now;
         }
+    }
+    if(updated & BOARD_POSITION_UPDATED)
+    {
+        /* whole board map, only when changed. */
+        DrawingBoard_Position_pub.publish(board_detector.boards());
+    }
+}
 
+/* legacy vision message: LaserScan.ranges quadruples. */
+void board_pos_cb(const sensor_msgs::LaserScan::ConstPtr& msg)
+{
+	board_scan = *msg;
 
+//    ROS_INFO("vision message received!");
 
-        /* display and publish stable vision message. */
-        board10_last = board10;
-        DrawingBoard_Position_pub.publish(board10_pub);
-//        ROS_INFO("current pos:\n"
-//                "x = %5.3f y = %5.3f z = %5.3f\n",
-//                current_pos.pose.position.x,current_pos.pose.position.y,current_pos.pose.position.z);
-//        ROS_INFO("\nboard_0 position: %d x = %f y = %f z = %f\n"
-//                    "board_1 position: %d x = %f y = %f z = %f\n"
-//                    "board_2 position: %d x = %f y = %f z = %f\n"
-//                    "board_3 position: %d x = %f y = %f z = %f\n"
-//                    "board_4 position: %d x = %f y = %f z = %f\n"
-//                    "board_5 position: %d x = %f y = %f z = %f\n"
-//                    "board_6 position: %d x = %f y = %f z = %f\n"
-//                    "board_7 position: %d x = %f y = %f z = %f\n"
-//                    "board_8 position: %d x = %f y = %f z = %f\n"
-//                    "board_9 position: %d x = %f y = %f z = %f\n",
-//                    board10_pub.drawingboard[0].valid,board10_pub.drawingboard[0].x,board10_pub.drawingboard[0].y,board10_pub.drawingboard[0].z,
-//                    board10_pub.drawingboard[1].valid,board10_pub.drawingboard[1].x,board10_pub.drawingboard[1].y,board10_pub.drawingboard[1].z,
-//                    board10_pub.drawingboard[2].valid,board10_pub.drawingboard[2].x,board10_pub.drawingboard[2].y,board10_pub.drawingboard[2].z,
-//                    board10_pub.drawingboard[3].valid,board10_pub.drawingboard[3].x,board10_pub.drawingboard[3].y,board10_pub.drawingboard[3].z,
-//                    board10_pub.drawingboard[4].valid,board10_pub.drawingboard[4].x,board10_pub.drawingboard[4].y,board10_pub.drawingboard[4].z,
-//                    board10_pub.drawingboard[5].valid,board10_pub.drawingboard[5].x,board10_pub.drawingboard[5].y,board10_pub.drawingboard[5].z,
-//                    board10_pub.drawingboard[6].valid,board10_pub.drawingboard[6].x,board10_pub.drawingboard[6].y,board10_pub.drawingboard[6].z,
-//                    board10_pub.drawingboard[7].valid,board10_pub.drawingboard[7].x,board10_pub.drawingboard[7].y,board10_pub.drawingboard[7].z,
-//                    board10_pub.drawingboard[8].valid,board10_pub.drawingboard[8].x,board10_pub.drawingboard[8].y,board10_pub.drawingboard[8].z,
-//                    board10_pub.drawingboard[9].valid,board10_pub.drawingboard[9].x,board10_pub.drawingboard[9].y,board10_pub.drawingboard[9].z);
+    board_publish(board_detector.update(camera_switch_data.data, board_scan, capture_position(board_scan.header.stamp)));
+}
 
-    }
+/* typed vision message: read in place. */
+void board_detections_cb(const state_machine::BoardDetections::ConstPtr& msg)
+{
+    board_publish(board_detector.update(camera_switch_data.data, *msg, capture_position(msg->header.stamp)));
 }
 
 
@@ -177,12 +132,42 @@ int main(int argc, char **argv)
 	ROS_INFO("I was alive.");
 	ros::init(argc, argv, "get_board_pos");
 	ros::NodeHandle nh;
+    ros::NodeHandle nh_private("~");
+
+    /* background mapping: boards seen in any phase, weighted by phase. */
+    BoardMappingConfig mapping = board_mapping_default_config();
+    nh_private.param("background_mapping", mapping.background, mapping.background);
+    nh_private.param("mapping_weight_transit", mapping.weight[0], mapping.weight[0]);
+    nh_private.param("mapping_weight_num", mapping.weight[1], mapping.weight[1]);
+    nh_private.param("mapping_weight_scan", mapping.weight[2], mapping.weight[2]);
+    board_detector.set_mapping(mapping);
+
+    /* board estimator: published once the position std dev is below board_sigma_usable. */
+    BoardEstimatorConfig estimator = board_estimator_default_config();
+    nh_private.param("board_sigma_measurement", estimator.sigma_measurement, estimator.sigma_measurement);
+    nh_private.param("board_sigma_usable", estimator.sigma_usable, estimator.sigma_usable);
+    nh_private.param("board_gate", estimator.gate, estimator.gate);
+    board_detector.set_estimator(estimator);
+
+    /* num voting: decided once certain(posterior above num_confidence). */
+    DigitVoterConfig voter = digit_voter_default_config();
+    nh_private.param("num_window", voter.window, voter.window);
+    nh_private.param("num_confidence", voter.confidence, voter.confidence);
+    nh_private.param("num_misread", voter.misread, voter.misread);
+    nh_private.param("num_min_votes", voter.min_votes, voter.min_votes);
+    board_detector.set_voter(voter);
+
+    pose_history_reset(pose_history);
+    nh_private.param("vision_delay", vision_delay, vision_delay);
 
     DrawingBoard_Position_pub = nh.advertise<state_machine::DrawingBoard10>("DrawingBoard_Position10", 1);
+    nh_private.param("board_keyframe_period", board_keyframe_period, board_keyframe_period);
+    board_delta_pub = nh.advertise<state_machine::BoardMapDelta>("board_map_delta", 10);
 
 	ros::Subscriber board_pos_sub = nh.subscribe<sensor_msgs::LaserScan>
 	            ("/vision/digit_nws_position", 10, board_pos_cb);
-	board10.drawingboard.resize(10);		/* MUST! -libn */
+    ros::Subscriber board_detections_sub = nh.subscribe<state_machine::BoardDetections>
+                ("/vision/board_detections", 10, board_detections_cb);
 
 	/* get pixhawk's local position. -libn */
 	ros::Subscriber local_pos_sub = nh.subscribe<geometry_msgs::PoseStamped>("mavros/local_position/pose", 10, pos_cb);
@@ -191,19 +176,9 @@ int main(int argc, char **argv)
 
     /* publish vision_num. */
     vision_num_pub  = nh.advertise<std_msgs::Int32>("vision_num", 10);
+    vision_num_vote_pub  = nh.advertise<state_machine::DigitVote>("vision_num_vote", 10);
+    nh_private.param("num_republish_period", num_republish_period, num_republish_period);
 
-	for(int i = 0; i < 10; i++)
-	{
-        board10.drawingboard[i].num = 66;
-        board10.drawingboard[i].x = 0.0f;
-        board10.drawingboard[i].y = 0.0f;
-        board10.drawingboard[i].z = 0.0f;
-        board10.drawingboard[i].valid = false;
-
-	}
-
-    board10_last = board10;
-    board10_pub = board10;
 	last_request = ros::Time::now();
 
 	ros::spin();
@@ -0,0 +1,1121 @@
+/**
+* @file     : mission.cpp
+* @brief    : mission of offb_simulation_test written as a transition table:
+*             takeoff -> scan -> 5 loops(observe, locate, spray) -> fix failures -> return home -> land.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/mission.h>
+
+#include <math.h>
+
+using state_machine::MissionState;
+using state_machine::MissionTransition;
+using state_machine::MISSION_EVENT_NONE;
+
+/* calculate distance */
+double circle_distance(double x1, double x2, double y1, double y2, double z1, double z2)
+{
+    return sqrt((x2-x1)*(x2-x1)+(y2-y1)*(y2-y1)+(z2-z1)*(z2-z1));
+}
+
+/* limit angle_rad to [-pi,pi]. */
+float wrap_pi(float angle_rad)
+{
+    /* value is inf or NaN */
+    if (angle_rad > 10 || angle_rad < -10) {
+        return angle_rad;
+    }
+    int c = 0;
+    while (angle_rad >= M_PI) {
+        angle_rad -= M_PI*2;
+
+        if (c++ > 3) {
+            return NAN;
+        }
+    }
+    c = 0;
+    while (angle_rad < -M_PI) {
+        angle_rad += M_PI*2;
+
+        if (c++ > 3) {
+            return NAN;
+        }
+    }
+    return angle_rad;
+}
+
+/* transform to ENU from NED. */
+void position_x_ENU_from_NED(float x_NED, float y_NED, float z_NED, float* pos_ENU_f)
+{
+    *pos_ENU_f = y_NED;
+    *(pos_ENU_f+1) = x_NED;
+    *(pos_ENU_f+2) = -z_NED;
+}
+
+/* ---------------------------------------------------------------- helpers */
+
+static void switch_camera(MissionContext& ctx, int data)
+{
+    /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
+    ctx.camera_switch = data;
+    ctx.camera_switch_pending = true;
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("send camera_switch_data = %d",data);
+    #endif
+}
+
+static bool timer_elapsed(const MissionContext& ctx, double seconds)
+{
+    return ctx.now - ctx.mission_last_time > ros::Duration(seconds);
+}
+
+static void reset_timer(MissionContext& ctx)
+{
+    ctx.mission_last_time = ctx.now;
+}
+
+static double distance_to_setpoint(const MissionContext& ctx)
+{
+    return circle_distance(ctx.current_pos.position.x,ctx.pose_pub.pose.position.x,
+                           ctx.current_pos.position.y,ctx.pose_pub.pose.position.y,
+                           ctx.current_pos.position.z,ctx.pose_pub.pose.position.z);
+}
+
+static bool board_valid(const MissionContext& ctx)
+{
+    return ctx.current_mission_num >= 0 &&
+           ctx.current_mission_num < BOARD_NUM_MAX &&
+           ctx.board[ctx.current_mission_num].valid;
+}
+
+static void set_position(MissionContext& ctx, double x, double y, double z)
+{
+    ctx.velocity_control_enable = false;    /* position setpoint: ends a scan sweep. */
+    ctx.pose_pub.pose.position.x = x;
+    ctx.pose_pub.pose.position.y = y;
+    ctx.pose_pub.pose.position.z = z;
+}
+
+/* hover in current position. -libn */
+static void hold_position(MissionContext& ctx)
+{
+    set_position(ctx, ctx.current_pos.position.x,
+                      ctx.current_pos.position.y,
+                      ctx.current_pos.position.z);
+}
+
+/* scanning point in front of setpoint L/R. */
+static void set_scan_point(MissionContext& ctx, const geometry_msgs::PoseStamped& setpoint)
+{
+    set_position(ctx, setpoint.pose.position.x - SCAN_VISION_DISTANCE * cos(ctx.yaw_sp),
+                      setpoint.pose.position.y - SCAN_VISION_DISTANCE * sin(ctx.yaw_sp),
+                      SCAN_HEIGHT);
+}
+
+/* point in front of board num at given distance. */
+static geometry_msgs::Point board_point(const MissionContext& ctx, int num, double distance)
+{
+    const BoardSnapshot& board = ctx.board[num];
+    geometry_msgs::Point point;
+    point.x = board.x - distance * cos(ctx.yaw_sp);
+    point.y = board.y - distance * sin(ctx.yaw_sp);
+    point.z = board.z + SAFE_HEIGHT_DISTANCE;
+    return point;
+}
+
+static void set_board_point(MissionContext& ctx, double distance)
+{
+    geometry_msgs::Point point = board_point(ctx, ctx.current_mission_num, distance);
+    set_position(ctx, point.x, point.y, point.z);
+}
+
+/* hover states: settled as soon as distance to setpoint and speed are steady within range.
+ * max_dwell/legacy_dwell: fixed timer(and its forced end) used before. */
+static const SettleConfig settle_after_takeoff =    {0.2,  0.2, 0.5, 0.5, 3.0, 3.0};
+static const SettleConfig settle_before_spary =     {0.1,  0.1, 0.5, 0.5, 7.0, 4.0};
+static const SettleConfig settle_arm_spread =       {0.05, 0.1, 0.5, 1.5, 6.5, 4.5};   /* min: arm spreading. */
+static const SettleConfig settle_force_home =       {0.2,  0.2, 0.5, 0.5, 2.0, 2.0};
+static const SettleConfig settle_before_land =      {0.2,  0.2, 0.5, 0.5, 1.0, 1.0};
+static const SettleConfig settle_spray =            {0.05, 0.1, 0.3, 0.0, SPRAY_WAIT_MAX, 0.0};    /* arm spread forced: valve waits. */
+
+/* sample hover of state, detector restarted when the state starts using it. */
+static void settle_step(MissionContext& ctx, int state, const SettleConfig& config)
+{
+    if(ctx.settle.state != state)
+    {
+        settle_reset(ctx.settle, state, ctx.now);
+    }
+    const geometry_msgs::Vector3& v = ctx.current_vel.linear;
+    settle_update(ctx.settle, config, ctx.now, distance_to_setpoint(ctx), sqrt(v.x*v.x + v.y*v.y + v.z*v.z));
+}
+
+static bool settled(const MissionContext& ctx, int state)
+{
+    return ctx.settle.state == state && ctx.settle.done;
+}
+
+/* leaving a hover state: dwell saved against the fixed timer. */
+static void settle_finish(MissionContext& ctx, const SettleConfig& config)
+{
+    double dwell = settle_dwell(ctx.settle, ctx.now);
+    ctx.settle_saved += config.legacy_dwell - dwell;
+    ROS_INFO("state %d settled%s after %.2f s, saved %.2f s(total %.2f s)",
+             ctx.settle.state, ctx.settle.forced ? "(forced)" : "", dwell,
+             config.legacy_dwell - dwell, ctx.settle_saved);
+    ctx.settle.state = 0;
+}
+
+/* scheduler cost model: moves from the current pose, hovers from the state configs(s). */
+static double move_cost(const MissionContext& ctx, const geometry_msgs::Point& to)
+{
+    const geometry_msgs::Point& p = ctx.current_pos.position;
+    return schedule_move_cost(ctx.schedule_config, circle_distance(p.x, to.x, p.y, to.y, p.z, to.z));
+}
+
+/* hover before spray, arm spread, spray and arm stretch back. */
+static double spray_cost(const MissionContext& ctx)
+{
+    return settle_before_spary.min_dwell + settle_arm_spread.min_dwell + ctx.spray_config.duration + 0.5;
+}
+
+/* cost to finish the current loop. board unknown: loop estimate. */
+static double loop_cost_left(const MissionContext& ctx, int state)
+{
+    double estimate = ctx.schedule.loop_estimate;
+    if(ctx.loop == 0)
+    {
+        return estimate;    /* takeoff and scan: no board yet. */
+    }
+    switch(state)
+    {
+    case mission_observe_point_go:
+    case mission_observe_num_wait:
+        /* num not read yet: board of this loop unknown. */
+        return fmax(estimate - ctx.schedule.loop_elapsed,
+                    move_cost(ctx, ctx.setpoint_A.pose.position) + spray_cost(ctx));
+    case mission_num_search:
+    case mission_num_locate:
+    case mission_num_get_close:
+        if(!board_valid(ctx))
+        {
+            return estimate;
+        }
+        return move_cost(ctx, board_point(ctx, ctx.current_mission_num, SPRAY_DISTANCE)) + spray_cost(ctx) +
+               (state == mission_num_locate ? 1.0 : 0.0);
+    case mission_hover_before_spary:
+        return spray_cost(ctx);
+    case mission_arm_spread:
+        return spray_cost(ctx) - settle_before_spary.min_dwell;
+    case mission_num_hover_spray:
+        if(ctx.spray.phase == SPRAY_ON)
+        {
+            return fmax(0.0, ctx.spray_config.duration - (ctx.now - ctx.spray.on_at).toSec()) + 0.5;
+        }
+        return ctx.spray_config.duration + 0.5;
+    case mission_hover_after_stretch_back:
+        return 0.5;
+    default:
+        return estimate;    /* scanning for the board. */
+    }
+}
+
+static double home_cost(const MissionContext& ctx)
+{
+    return move_cost(ctx, ctx.setpoint_H.pose.position) + ctx.schedule_config.land_cost;
+}
+
+/* cost to repair a failure from here: fly to its board and spray, or a loop when the board is unknown. */
+static double retry_cost(const MissionContext& ctx, const RetryEntry& entry)
+{
+    if(entry.policy == RETRY_SCAN || !ctx.board[entry.num].valid)
+    {
+        return ctx.schedule.loop_estimate;
+    }
+    return move_cost(ctx, board_point(ctx, entry.num, SPRAY_DISTANCE)) + spray_cost(ctx);
+}
+
+/* how a loop failed in state is retried. */
+static RetryPolicy retry_policy(const MissionContext& ctx, int state)
+{
+    if(ctx.loop == 0)
+    {
+        return RETRY_NONE;      /* takeoff and scan: no board. */
+    }
+    switch(state)
+    {
+    case mission_observe_point_go:
+    case mission_observe_num_wait:
+        return RETRY_NONE;      /* num of this loop not read. */
+    case mission_num_search:
+    case mission_num_locate:
+    case mission_num_get_close:
+        return board_valid(ctx) ? RETRY_APPROACH : RETRY_SCAN;
+    case mission_hover_before_spary:
+    case mission_arm_spread:
+        return RETRY_HOVER;
+    case mission_num_hover_spray:
+    case mission_hover_after_stretch_back:
+        return RETRY_NONE;      /* sprayed. */
+    default:
+        return RETRY_SCAN;      /* scanning for the board. */
+    }
+}
+
+/* states of the return: loop decisions do not apply. */
+static bool returning(int state)
+{
+    return state == mission_num_done || state == mission_fix_failure ||
+           state == mission_force_return_home || state == mission_return_home ||
+           state == mission_hover_only || state == land;
+}
+
+/* ---------------------------------------------------------------- actions */
+
+static void takeoff_action(MissionContext& ctx)
+{
+    schedule_start(ctx.schedule, ctx.now);     /* flight budget starts once. */
+    /* local velocity setpoint publish. -libn */
+    ctx.velocity_control_enable = true;
+    ctx.vel_pub.twist.linear.x = 0.0f;
+    ctx.vel_pub.twist.linear.y = 0.0f;
+    ctx.vel_pub.twist.linear.z = 2.2f;
+    ctx.vel_pub.twist.angular.x = 0.0f;
+    ctx.vel_pub.twist.angular.y = 0.0f;
+    ctx.vel_pub.twist.angular.z = 0.0f;
+}
+
+static void hover_after_takeoff_action(MissionContext& ctx)
+{
+    set_position(ctx, ctx.current_pos.position.x,
+                      ctx.current_pos.position.y,
+                      ctx.setpoint_H.pose.position.z);
+    settle_step(ctx, mission_hover_after_takeoff, settle_after_takeoff);
+}
+
+static void scan_left_action(MissionContext& ctx)
+{
+    set_scan_point(ctx, ctx.setpoint_L);
+}
+
+static void scan_right_action(MissionContext& ctx)
+{
+    set_scan_point(ctx, ctx.setpoint_R);
+}
+
+/* continuous scan: velocity towards the scan point of setpoint, constant along the baseline and
+ * slowing down within the last SCAN_SWEEP_TAU. pose_pub keeps the end of the pass for the arrival check. */
+static void scan_sweep(MissionContext& ctx, const geometry_msgs::PoseStamped& setpoint)
+{
+    set_scan_point(ctx, setpoint);
+    double dx = ctx.pose_pub.pose.position.x - ctx.current_pos.position.x;
+    double dy = ctx.pose_pub.pose.position.y - ctx.current_pos.position.y;
+    double dz = ctx.pose_pub.pose.position.z - ctx.current_pos.position.z;
+    double distance = sqrt(dx*dx + dy*dy + dz*dz);
+    double k = distance > 1e-3 ? fmin(ctx.scan_sweep_speed, distance / SCAN_SWEEP_TAU) / distance : 0.0;
+    ctx.velocity_control_enable = true;
+    ctx.vel_pub.twist.linear.x = k * dx;
+    ctx.vel_pub.twist.linear.y = k * dy;
+    ctx.vel_pub.twist.linear.z = k * dz;
+    ctx.vel_pub.twist.angular.x = 0.0f;
+    ctx.vel_pub.twist.angular.y = 0.0f;
+    ctx.vel_pub.twist.angular.z = 0.0f;
+}
+
+static void scan_sweep_right_action(MissionContext& ctx)
+{
+    scan_sweep(ctx, ctx.setpoint_R);
+}
+
+static void scan_sweep_left_action(MissionContext& ctx)
+{
+    scan_sweep(ctx, ctx.setpoint_L);
+}
+
+static void observe_point_go_action(MissionContext& ctx)
+{
+    if(ctx.loop > 5)
+    {
+        return;
+    }
+    set_position(ctx, ctx.setpoint_A.pose.position.x,
+                      ctx.setpoint_A.pose.position.y,
+                      ctx.setpoint_A.pose.position.z);
+    /* camera_switch revised. */
+    if((fabs(ctx.current_pos.position.x - ctx.pose_pub.pose.position.x) < 1.0) &&
+       (fabs(ctx.current_pos.position.y - ctx.pose_pub.pose.position.y) < 1.0))
+    {
+        switch_camera(ctx, 1);
+    }
+}
+
+static void observe_num_wait_action(MissionContext& ctx)
+{
+    set_position(ctx, ctx.setpoint_A.pose.position.x,
+                      ctx.setpoint_A.pose.position.y,
+                      ctx.setpoint_A.pose.position.z);
+}
+
+static void num_search_action(MissionContext& ctx)
+{
+    if(board_valid(ctx))
+    {
+        set_board_point(ctx, VISION_SCAN_DISTANCE);
+    }
+}
+
+static void vision_scan_point_action(MissionContext& ctx)
+{
+    set_board_point(ctx, VISION_SCAN_DISTANCE);
+}
+
+static void spray_point_action(MissionContext& ctx)
+{
+    set_board_point(ctx, SPRAY_DISTANCE);
+}
+
+static void hover_before_spary_action(MissionContext& ctx)
+{
+    set_board_point(ctx, SPRAY_DISTANCE);
+    settle_step(ctx, mission_hover_before_spary, settle_before_spary);
+}
+
+static void arm_spread_action(MissionContext& ctx)
+{
+    set_board_point(ctx, SPRAY_DISTANCE);
+    settle_step(ctx, mission_arm_spread, settle_arm_spread);    /* enter 0.05 range */
+}
+
+static void num_hover_spray_action(MissionContext& ctx)
+{
+    set_board_point(ctx, SPRAY_DISTANCE);
+    ctx.loop_timer_disable = true;
+    if(ctx.spray.phase == SPRAY_WAIT)
+    {
+        settle_step(ctx, mission_num_hover_spray, settle_spray);
+    }
+    spray_update(ctx.spray, ctx.spray_config, ctx.now, settled(ctx, mission_num_hover_spray));
+    /* add height adjustment(0.5s after spraying started). */
+    if(ctx.spray.phase != SPRAY_WAIT && (ctx.now - ctx.spray.on_at).toSec() >= 0.5)
+    {
+        ctx.pose_pub.pose.position.z -= 0.05f;
+    }
+}
+
+static void hold_position_action(MissionContext& ctx)
+{
+    hold_position(ctx);
+}
+
+/* cheapest failure that still fits in the flight budget: most boards per second left. */
+static void fix_failure_action(MissionContext& ctx)
+{
+    if(ctx.fix_failure.retry)
+    {
+        return;
+    }
+    for(int i = 0; i < ctx.retry.count; ++i)
+    {
+        ctx.retry.entry[i].cost = retry_cost(ctx, ctx.retry.entry[i]);
+    }
+    if(retry_pop(ctx.retry, schedule_available(ctx.schedule, ctx.schedule_config), ctx.fix_failure.entry))
+    {
+        ctx.current_mission_num = ctx.fix_failure.entry.num;
+        ctx.fix_failure.retry = true;
+    }
+}
+
+static void force_return_home_action(MissionContext& ctx)
+{
+    hold_position(ctx);
+    settle_step(ctx, mission_force_return_home, settle_force_home);
+}
+
+static void home_action(MissionContext& ctx)
+{
+    set_position(ctx, ctx.setpoint_H.pose.position.x,
+                      ctx.setpoint_H.pose.position.y,
+                      ctx.setpoint_H.pose.position.z);
+}
+
+static void hover_only_action(MissionContext& ctx)
+{
+    home_action(ctx);
+    settle_step(ctx, mission_hover_only, settle_before_land);
+}
+
+/* ---------------------------------------------------------------- guards */
+
+static bool always(const MissionContext&)
+{
+    return true;
+}
+
+static bool takeoff_done(const MissionContext& ctx)
+{
+    return ctx.current_vel.linear.z > 0.5 &&
+           ctx.current_pos.position.z > 0.8;
+}
+
+static bool after_takeoff_settled(const MissionContext& ctx)
+{
+    return settled(ctx, mission_hover_after_takeoff);
+}
+
+static bool hovered_1s(const MissionContext& ctx)
+{
+    return timer_elapsed(ctx, 1);
+}
+
+static bool hovered_half_s(const MissionContext& ctx)
+{
+    return timer_elapsed(ctx, 0.5);
+}
+
+static bool setpoint_reached(const MissionContext& ctx)
+{
+    return distance_to_setpoint(ctx) < 0.2;
+}
+
+static bool sweep_start_reached(const MissionContext& ctx)
+{
+    return ctx.scan_continuous && setpoint_reached(ctx);
+}
+
+static bool sweep_end_reached(const MissionContext& ctx)
+{
+    return distance_to_setpoint(ctx) < SCAN_SWEEP_TURN;
+}
+
+/* searching while sweeping: leave as soon as the board is seen. */
+static bool sweep_found_board(const MissionContext& ctx)
+{
+    return ctx.scan_to_get_pos && board_valid(ctx);
+}
+
+static bool sweep_missed_board(const MissionContext& ctx)
+{
+    return ctx.scan_to_get_pos && sweep_end_reached(ctx);
+}
+
+static bool scan_found_board(const MissionContext& ctx)
+{
+    return timer_elapsed(ctx, 1) && ctx.scan_to_get_pos && board_valid(ctx);
+}
+
+static bool scan_missed_board(const MissionContext& ctx)
+{
+    return timer_elapsed(ctx, 1) && ctx.scan_to_get_pos;
+}
+
+static bool all_loops_done(const MissionContext& ctx)
+{
+    return ctx.loop > 5;
+}
+
+static bool new_num_observed(const MissionContext& ctx)
+{
+    /* same num as last loop: stay, avoid repeating spraying.
+     * a num voted certain(vision_num_vote) is left at once, otherwise after 1s. */
+    return ctx.current_mission_num != ctx.last_mission_num && (ctx.num_confidence > 0.0f || timer_elapsed(ctx, 1));
+}
+
+static bool board_point_near(const MissionContext& ctx)
+{
+    return board_valid(ctx) && distance_to_setpoint(ctx) < 0.6;
+}
+
+static bool board_unknown(const MissionContext& ctx)
+{
+    return !board_valid(ctx);
+}
+
+static bool spray_point_reached(const MissionContext& ctx)
+{
+    return distance_to_setpoint(ctx) < 0.15;
+}
+
+static bool hover_before_spary_done(const MissionContext& ctx)
+{
+    return settled(ctx, mission_hover_before_spary);
+}
+
+static bool arm_spread_done(const MissionContext& ctx)
+{
+    return settled(ctx, mission_arm_spread);
+}
+
+static bool force_home_settled(const MissionContext& ctx)
+{
+    return settled(ctx, mission_force_return_home);
+}
+
+static bool before_land_settled(const MissionContext& ctx)
+{
+    return settled(ctx, mission_hover_only);
+}
+
+static bool sprayed(const MissionContext& ctx)
+{
+    return ctx.spray.phase == SPRAY_DONE;   /* spray time delivered. */
+}
+
+static bool last_loop_stretched_back(const MissionContext& ctx)
+{
+    return timer_elapsed(ctx, 0.5) && ctx.loop + 1 > 5;
+}
+
+static bool failures_recorded(const MissionContext& ctx)
+{
+    return FAILURE_REPAIR && ctx.retry.count != 0;
+}
+
+static bool failure_to_retry(const MissionContext& ctx)
+{
+    return ctx.fix_failure.retry && ctx.fix_failure.entry.policy != RETRY_SCAN;
+}
+
+static bool failure_to_scan(const MissionContext& ctx)
+{
+    return ctx.fix_failure.retry && ctx.fix_failure.entry.policy == RETRY_SCAN;
+}
+
+static bool failures_empty(const MissionContext& ctx)
+{
+    return ctx.retry.count == 0;
+}
+
+/* failures left, none fits in the flight budget. */
+static bool repair_unaffordable(const MissionContext& ctx)
+{
+    return !ctx.fix_failure.retry;
+}
+
+static bool home_reached(const MissionContext& ctx)
+{
+    return (fabs(ctx.current_pos.position.x - ctx.setpoint_H.pose.position.x) < 0.2) &&
+           (fabs(ctx.current_pos.position.y - ctx.setpoint_H.pose.position.y) < 0.2) &&
+           (fabs(ctx.current_pos.position.z - ctx.setpoint_H.pose.position.z) < 0.2) &&
+           timer_elapsed(ctx, 1);
+}
+
+/* ---------------------------------------------------------------- effects */
+
+static void restart_timer(MissionContext& ctx)
+{
+    reset_timer(ctx);
+}
+
+static void takeoff_exit(MissionContext& ctx)
+{
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("current_vel.linear.x = %f",ctx.current_vel.linear.x);
+    #endif
+    reset_timer(ctx);
+    ctx.velocity_control_enable = false;
+    hover_after_takeoff_action(ctx);
+    switch_camera(ctx, 0);
+}
+
+static void scan_start(MissionContext& ctx)
+{
+    reset_timer(ctx);
+    switch_camera(ctx, 2);
+}
+
+static void scan_locate_board(MissionContext& ctx)
+{
+    reset_timer(ctx);
+    ctx.scan_to_get_pos = false;
+}
+
+static void scan_search_board(MissionContext& ctx)
+{
+    ctx.scan_to_get_pos = false;
+    switch_camera(ctx, 0);
+}
+
+static void scan_again(MissionContext& ctx)
+{
+    switch_camera(ctx, 0);
+}
+
+static void scan_finish(MissionContext& ctx)
+{
+    reset_timer(ctx);
+    ctx.loop++;
+    switch_camera(ctx, 0);
+}
+
+static void num_observed(MissionContext& ctx)
+{
+    /* change and publish camera_switch_data for next subtask. */
+    switch_camera(ctx, 2);
+    ctx.last_mission_num = ctx.current_mission_num;
+}
+
+static void board_point_arrived(MissionContext& ctx)
+{
+    reset_timer(ctx);
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("mission switched well!");
+    #endif
+}
+
+static void board_search_by_scan(MissionContext& ctx)
+{
+    ctx.scan_to_get_pos = true;
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("fall into mission state: mission_num_scan_again");
+    #endif
+}
+
+static void after_takeoff_exit(MissionContext& ctx)
+{
+    settle_finish(ctx, settle_after_takeoff);
+}
+
+static void hover_before_spary_exit(MissionContext& ctx)
+{
+    settle_finish(ctx, settle_before_spary);
+    reset_timer(ctx);
+}
+
+static void arm_spread_exit(MissionContext& ctx)
+{
+    bool settled = !ctx.settle.forced;
+    settle_finish(ctx, settle_arm_spread);
+    /* num lost(MANUAL while armed, then OFFBOARD again mid-loop): no spray, no record. */
+    if(ctx.current_mission_num >= 0 && ctx.current_mission_num < BOARD_NUM_MAX)
+    {
+        spray_start(ctx.spray, ctx.spray_config, ctx.current_mission_num, ctx.now, settled);
+    }
+    else
+    {
+        /* valve kept closed, mission_num_hover_spray left at once. */
+        ROS_INFO("board num %d out of range, not sprayed", ctx.current_mission_num);
+        ctx.spray.board = -1;
+        ctx.spray.enter = ctx.spray.on_at = ctx.spray.off_at = ctx.now;
+        ctx.spray.phase = SPRAY_DONE;
+    }
+    reset_timer(ctx);
+}
+
+static void force_home_exit(MissionContext& ctx)
+{
+    settle_finish(ctx, settle_force_home);
+}
+
+static void before_land_exit(MissionContext& ctx)
+{
+    settle_finish(ctx, settle_before_land);
+}
+
+/* spray ended(or aborted): latency and spray time of the board. */
+static void spray_finish(MissionContext& ctx)
+{
+    if(ctx.spray.phase == SPRAY_IDLE)
+    {
+        return;
+    }
+    spray_abort(ctx.spray, ctx.spray_config, ctx.now);    /* valve closed if still open. */
+    if(ctx.spray.board < 0 || ctx.spray.board >= BOARD_NUM_MAX)
+    {
+        ctx.spray.phase = SPRAY_IDLE;
+        return;
+    }
+    SprayRecord& record = ctx.spray_record[ctx.spray.board];
+    spray_record(ctx.spray, record);
+    ROS_INFO("board %d sprayed %.2f s%s, spray start latency %.2f s",
+             ctx.spray.board, record.sprayed, record.forced ? "(not settled)" : "", record.latency);
+    ctx.spray.phase = SPRAY_IDLE;
+    if(ctx.settle.state == mission_num_hover_spray)
+    {
+        ctx.settle.state = 0;
+    }
+}
+
+static void spray_done(MissionContext& ctx)
+{
+    if(ctx.schedule.repair)
+    {
+        ctx.retry.recovered++;
+    }
+    spray_finish(ctx);
+    reset_timer(ctx);
+    ctx.loop_timer_disable = false; /* enable loop_timer. */
+}
+
+static void next_loop(MissionContext& ctx)
+{
+    ctx.loop++;	/* switch to next loop. -libn */
+}
+
+static void fix_failure_enter(MissionContext& ctx)
+{
+    /* cheapest entry for now, fix_failure_action() picks again from the pose it is in. */
+    int next = -1;
+    double next_cost = 0.0;
+    for(int i = 0; i < ctx.retry.count; ++i)
+    {
+        double cost = retry_cost(ctx, ctx.retry.entry[i]);
+        if(next < 0 || cost < next_cost)
+        {
+            next = i;
+            next_cost = cost;
+        }
+    }
+    if(next >= 0)
+    {
+        ROS_INFO("fixing failures: %d queued, %.1f s available, next board %d(%s) estimated %.1f s",
+                 ctx.retry.count, schedule_available(ctx.schedule, ctx.schedule_config),
+                 ctx.retry.entry[next].num, retry_policy_name(ctx.retry.entry[next].policy), next_cost);
+    }
+}
+
+static void go_home(MissionContext& ctx)
+{
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("going to mission_return_home");
+    #endif
+    reset_timer(ctx);
+}
+
+static void failure_retry(MissionContext& ctx)
+{
+    const RetryEntry& entry = ctx.fix_failure.entry;
+    ctx.fix_failure.retry = false;
+    schedule_repair(ctx.schedule, 1.5 * entry.cost, ctx.now);
+    ROS_INFO("retry board %d(%s, attempt %d), estimated %.1f s",
+             entry.num, retry_policy_name(entry.policy), entry.attempts, entry.cost);
+}
+
+static void failure_scan(MissionContext& ctx)
+{
+    failure_retry(ctx);
+    ctx.scan_to_get_pos = true;     /* scan until the board is found. */
+}
+
+static void failures_fixed(MissionContext&)
+{
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("All failure fixed, return to home.");
+    #endif
+}
+
+static void home_arrived(MissionContext& ctx)
+{
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("start mission_hover_only");
+    #endif
+    reset_timer(ctx);
+}
+
+/* ---------------------------------------------------------------- tables */
+
+static constexpr MissionState<MissionContext> mission_states[] =
+{
+    {takeoff,                           takeoff_action},
+    {mission_hover_after_takeoff,       hover_after_takeoff_action},
+    {mission_scan_left_go,              scan_left_action},
+    {mission_scan_right_move,           scan_right_action},
+    {mission_scan_right_hover,          scan_right_action},
+    {mission_scan_left_move,            scan_left_action},
+    {mission_scan_left_hover,           scan_left_action},
+    {mission_scan_sweep_right,          scan_sweep_right_action},
+    {mission_scan_sweep_left,           scan_sweep_left_action},
+    {mission_observe_point_go,          observe_point_go_action},
+    {mission_observe_num_wait,          observe_num_wait_action},
+    {mission_num_search,                num_search_action},
+    {mission_num_locate,                vision_scan_point_action},
+    {mission_num_get_close,             spray_point_action},
+    {mission_hover_before_spary,        hover_before_spary_action},
+    {mission_arm_spread,                arm_spread_action},
+    {mission_num_hover_spray,           num_hover_spray_action},
+    {mission_hover_after_stretch_back,  hold_position_action},
+    {mission_num_done,                  hold_position_action},
+    {mission_fix_failure,               fix_failure_action},
+    {mission_force_return_home,         force_return_home_action},
+    {mission_return_home,               home_action},
+    {mission_hover_only,                hover_only_action},
+    {land,                              NULL},
+};
+
+/* grouped by source state, guards of one state are checked in order. */
+static constexpr MissionTransition<MissionContext> mission_transitions[] =
+{
+    {takeoff,                            takeoff_done,               takeoff_exit,               mission_hover_after_takeoff,        MISSION_EVENT_POSE},
+    {mission_hover_after_takeoff,        after_takeoff_settled,      after_takeoff_exit,         mission_scan_left_go,               MISSION_EVENT_NONE},
+
+    /* scan mission. */
+    {mission_scan_left_go,               sweep_start_reached,        scan_start,                 mission_scan_sweep_right,           MISSION_EVENT_POSE},
+    {mission_scan_left_go,               setpoint_reached,           scan_start,                 mission_scan_right_move,            MISSION_EVENT_POSE},
+    {mission_scan_right_move,            setpoint_reached,           restart_timer,              mission_scan_right_hover,           MISSION_EVENT_POSE},
+    {mission_scan_right_hover,           scan_found_board,           scan_locate_board,          mission_num_locate,                 MISSION_EVENT_NONE},
+    {mission_scan_right_hover,           hovered_1s,                 restart_timer,              mission_scan_left_move,             MISSION_EVENT_NONE},
+    {mission_scan_left_move,             setpoint_reached,           restart_timer,              mission_scan_left_hover,            MISSION_EVENT_POSE},
+    {mission_scan_left_hover,            scan_found_board,           scan_search_board,          mission_num_search,                 MISSION_EVENT_NONE},
+    {mission_scan_left_hover,            scan_missed_board,          scan_again,                 mission_scan_left_go,               MISSION_EVENT_NONE},
+    {mission_scan_left_hover,            hovered_1s,                 scan_finish,                mission_observe_point_go,           MISSION_EVENT_NONE},
+    {mission_scan_sweep_right,           sweep_found_board,          scan_locate_board,          mission_num_locate,                 MISSION_EVENT_POSE},
+    {mission_scan_sweep_right,           sweep_end_reached,          NULL,                       mission_scan_sweep_left,            MISSION_EVENT_POSE},
+    {mission_scan_sweep_left,            sweep_found_board,          scan_search_board,          mission_num_search,                 MISSION_EVENT_POSE},
+    {mission_scan_sweep_left,            sweep_missed_board,         scan_again,                 mission_scan_left_go,               MISSION_EVENT_POSE},
+    {mission_scan_sweep_left,            sweep_end_reached,          scan_finish,                mission_observe_point_go,           MISSION_EVENT_POSE},
+
+    /* 5 loops. */
+    {mission_observe_point_go,           all_loops_done,             NULL,                       mission_num_done,                   MISSION_EVENT_NONE},
+    {mission_observe_point_go,           setpoint_reached,           restart_timer,              mission_observe_num_wait,           MISSION_EVENT_POSE},
+    {mission_observe_num_wait,           new_num_observed,           num_observed,               mission_num_search,                 MISSION_EVENT_NONE},
+    {mission_num_search,                 board_point_near,           board_point_arrived,        mission_num_get_close,              MISSION_EVENT_POSE},
+    {mission_num_search,                 board_unknown,              board_search_by_scan,       mission_scan_left_go,               MISSION_EVENT_NONE},
+    {mission_num_locate,                 hovered_1s,                 restart_timer,              mission_num_get_close,              MISSION_EVENT_NONE},
+    {mission_num_get_close,              spray_point_reached,        restart_timer,              mission_hover_before_spary,         MISSION_EVENT_POSE},
+    {mission_hover_before_spary,         hover_before_spary_done,    hover_before_spary_exit,    mission_arm_spread,                 MISSION_EVENT_NONE},
+    {mission_arm_spread,                 arm_spread_done,            arm_spread_exit,            mission_num_hover_spray,            MISSION_EVENT_NONE},
+    {mission_num_hover_spray,            sprayed,                    spray_done,                 mission_hover_after_stretch_back,   MISSION_EVENT_NONE},
+    {mission_hover_after_stretch_back,   last_loop_stretched_back,   next_loop,                  mission_num_done,                   MISSION_EVENT_NONE},
+    {mission_hover_after_stretch_back,   hovered_half_s,             next_loop,                  mission_observe_point_go,           MISSION_EVENT_NONE},
+
+    /* failures and return. */
+    {mission_num_done,                   failures_recorded,          fix_failure_enter,          mission_fix_failure,                MISSION_EVENT_NONE},
+    {mission_num_done,                   always,                     go_home,                    mission_return_home,                MISSION_EVENT_NONE},
+    {mission_fix_failure,                failure_to_retry,           failure_retry,              mission_num_search,                 MISSION_EVENT_NONE},
+    {mission_fix_failure,                failure_to_scan,            failure_scan,               mission_scan_left_go,               MISSION_EVENT_NONE},
+    {mission_fix_failure,                failures_empty,             failures_fixed,             mission_return_home,                MISSION_EVENT_NONE},
+    {mission_fix_failure,                repair_unaffordable,        go_home,                    mission_return_home,                MISSION_EVENT_NONE},
+    {mission_force_return_home,          force_home_settled,         force_home_exit,            mission_return_home,                MISSION_EVENT_NONE},
+    {mission_return_home,                home_reached,               home_arrived,               mission_hover_only,                 MISSION_EVENT_POSE},
+    {mission_hover_only,                 before_land_settled,        before_land_exit,           land,                               MISSION_EVENT_NONE},
+};
+
+OffbMissionEngine mission_engine(int initial_state)
+{
+    return OffbMissionEngine(mission_states, mission_transitions, initial_state);
+}
+
+void mission_init(MissionContext& ctx)
+{
+    ctx.setpoint_H.pose.position.x = ctx.current_pos.position.x;
+    ctx.setpoint_H.pose.position.y = ctx.current_pos.position.y;
+    ctx.setpoint_H.pose.position.z = TAKEOFF_HEIGHT;  /* it's better to choose z* = SAFE_HEIGHT_DISTANCE(no altitude lost). */
+
+    ctx.setpoint_A.pose.position.x = 0.0f;
+    ctx.setpoint_A.pose.position.y = 0.0f;
+    ctx.setpoint_A.pose.position.z = FIXED_POS_HEIGHT;
+
+    ctx.setpoint_L.pose.position.x = 0.0f;
+    ctx.setpoint_L.pose.position.y = 0.0f;
+    ctx.setpoint_L.pose.position.z = SCAN_HEIGHT;
+
+    ctx.setpoint_R.pose.position.x = 0.0f;
+    ctx.setpoint_R.pose.position.y = 0.0f;
+    ctx.setpoint_R.pose.position.z = SCAN_HEIGHT;
+
+    ctx.setpoint_D.pose.position.x = 0.0f;
+    ctx.setpoint_D.pose.position.y = 0.0f;
+    ctx.setpoint_D.pose.position.z = FIXED_POS_HEIGHT;
+
+    ctx.yaw_sp = 90*M_PI/180;   /* default yaw*(90 degree)(ENU) -> North! */
+
+    for(int co = 0; co<BOARD_NUM_MAX; ++co)
+    {
+        ctx.board[co].valid = false;  /* Normly it should be false as the default setting. */
+        ctx.board[co].x = 0.0f;
+        ctx.board[co].y = 0.0f;
+        ctx.board[co].z = 0.0f;  /* it's safe for we have SAFE_HEIGHT_DISTANCE. */
+        ctx.board[co].version = 0;
+    }
+    ctx.current_mission_num = 0;    /* set current_mission_num as 0 as default. */
+    ctx.num_confidence = 0.0f;
+    ctx.last_mission_num = 0;
+
+    ctx.velocity_control_enable = true;
+    ctx.camera_switch = 0;
+    ctx.camera_switch_pending = true;
+
+    ctx.loop = 0;
+    ctx.schedule_config = schedule_default_config();
+    schedule_reset(ctx.schedule, ctx.schedule_config);
+    ctx.force_home_enable = true;
+    ctx.loop_timer_disable = false;
+    ctx.scan_to_get_pos = false;
+    ctx.scan_continuous = true;
+    ctx.scan_sweep_speed = SCAN_SWEEP_SPEED;
+
+    /* failure recorded. */
+    retry_reset(ctx.retry);
+    ctx.loop_timeout_count = 0;
+
+    settle_reset(ctx.settle, 0, ctx.now);
+    ctx.settle_saved = 0.0;
+    ctx.spray_config = spray_default_config();
+    spray_reset(ctx.spray, ctx.spray_config);
+    for(int co = 0; co < BOARD_NUM_MAX; ++co)
+    {
+        ctx.spray_record[co].count = 0;
+        ctx.spray_record[co].latency = 0.0;
+        ctx.spray_record[co].sprayed = 0.0;
+        ctx.spray_record[co].forced = false;
+    }
+    ctx.fix_failure.retry = false;
+}
+
+void pose_snapshot(PoseSnapshot& pose, const geometry_msgs::PoseStamped& msg)
+{
+    pose.position = msg.pose.position;
+    pose.stamp = msg.header.stamp;
+}
+
+void velocity_snapshot(VelocitySnapshot& vel, const geometry_msgs::TwistStamped& msg)
+{
+    vel.linear = msg.twist.linear;
+    vel.stamp = msg.header.stamp;
+}
+
+void boards_snapshot(BoardSnapshots& boards, const state_machine::DrawingBoard10& msg)
+{
+    /* entries placed by board num(any order, any number): boards 0~9 of the mission kept. */
+    for(int i = 0; i < BOARD_NUM_MAX; ++i)
+    {
+        boards.board[i].valid = false;
+        boards.board[i].version = 0;
+    }
+    boards.epoch = 0;
+    for(size_t i = 0; i < msg.drawingboard.size(); ++i)
+    {
+        const state_machine::DrawingBoard& board = msg.drawingboard[i];
+        if(board.num < 0 || board.num >= BOARD_NUM_MAX)
+        {
+            continue;
+        }
+        boards.board[board.num].x = board.x;
+        boards.board[board.num].y = board.y;
+        boards.board[board.num].z = board.z;
+        boards.board[board.num].valid = board.valid;
+        boards.board[board.num].version = board.version;
+    }
+}
+
+void mission_spray_stream(MissionContext& ctx, const ros::Time& now)
+{
+    /* opening stays with the tick(settle detector), sprayed() moves on at the next tick. */
+    if(ctx.spray.phase == SPRAY_ON)
+    {
+        spray_update(ctx.spray, ctx.spray_config, now, true);
+    }
+}
+
+void mission_timers(MissionContext& ctx, OffbMissionEngine& engine)
+{
+    int state = engine.state();
+    ScheduleDecision decision = schedule_update(ctx.schedule, ctx.schedule_config, ctx.now, ctx.loop,
+                                                loop_cost_left(ctx, state), home_cost(ctx));
+    if(decision == SCHEDULE_RETURN_HOME)
+    {
+        if(ctx.force_home_enable && (!returning(state) || state == mission_fix_failure))
+        {
+            ctx.force_home_enable = false; /* force once! */
+            spray_finish(ctx);
+            engine.force(mission_force_return_home);	/* flight budget spent. -libn */
+            ROS_INFO("flight budget left %.1f s, return %.1f s -> return to home!",
+                     ctx.schedule.remaining, ctx.schedule.home_cost);
+            reset_timer(ctx);   /* start counting time(for hovering). */
+        }
+        return;
+    }
+    /* loop decisions: never while spraying or returning. */
+    if(ctx.loop_timer_disable || returning(state))
+    {
+        return;
+    }
+    bool repair = ctx.schedule.repair;
+    if(decision == SCHEDULE_DEFER || decision == SCHEDULE_SKIP)
+    {
+        /* error recorded! retries of a retry are counted. */
+        int attempts = repair ? ctx.fix_failure.entry.attempts : 0;
+        if(decision == SCHEDULE_SKIP ||
+           !retry_push(ctx.retry, ctx.current_mission_num, state, retry_policy(ctx, state), attempts))
+        {
+            decision = SCHEDULE_SKIP;
+        }
+        schedule_loop_ended(ctx.schedule, decision);
+        ROS_INFO("%s %d over budget(%.1f s, %.1f s left) -> %s",
+                 repair ? "retry of board" : "loop", repair ? ctx.current_mission_num : ctx.loop,
+                 ctx.schedule.loop_budget, ctx.schedule.task_left, schedule_decision_name(decision));
+        if(repair)
+        {
+            engine.force(mission_fix_failure);  /* next failure. */
+            return;
+        }
+        ctx.loop++;
+        ctx.loop_timeout_count++;
+        engine.force(mission_observe_point_go);	/* loop over budget, forced to switch to next loop. -libn */
+    }
+    else if(decision == SCHEDULE_STOP && repair)
+    {
+        schedule_loop_ended(ctx.schedule, decision);
+        ctx.retry.dropped++;
+        engine.force(mission_fix_failure);  /* a cheaper failure may still fit. */
+    }
+    else if(decision == SCHEDULE_STOP)
+    {
+        schedule_loop_ended(ctx.schedule, decision);
+        ROS_INFO("loop %d needs %.1f s, not in flight budget -> no more loops",
+                 ctx.loop, ctx.schedule.task_left);
+        ctx.loop = SCHEDULE_LOOPS + 1;
+        engine.force(mission_num_done);
+    }
+}
+
+void mission_fixed_targets(MissionContext& ctx,
+                           const state_machine::FIXED_TARGET_POSITION_P2M& target,
+                           state_machine::FIXED_TARGET_RETURN_M2P& target_return)
+{
+    target_return.home_x = target.home_x;
+    target_return.home_y = target.home_y;
+    target_return.home_z = -TAKEOFF_HEIGHT;
+
+    target_return.observe_x = target.observe_x;
+    target_return.observe_y = target.observe_y;
+    target_return.observe_z = -FIXED_POS_HEIGHT;
+
+    target_return.spray_left_x = target.spray_left_x;
+    target_return.spray_left_y = target.spray_left_y;
+    target_return.spray_left_z = -SCAN_HEIGHT;
+
+    target_return.spray_right_x = target.spray_right_x;
+    target_return.spray_right_y = target.spray_right_y;
+    target_return.spray_right_z = -SCAN_HEIGHT;
+
+    /* get 4 fixed_setpoint. */
+    /* transform position from NED to ENU. */
+    float pos_ENU[3] = {0,0,0};
+    position_x_ENU_from_NED(target.home_x, target.home_y, target.home_z, pos_ENU);
+    ctx.setpoint_H.pose.position.x = pos_ENU[0];
+    ctx.setpoint_H.pose.position.y = pos_ENU[1];
+
+    position_x_ENU_from_NED(target.observe_x, target.observe_y, target.observe_z, pos_ENU);
+    ctx.setpoint_A.pose.position.x = pos_ENU[0];
+    ctx.setpoint_A.pose.position.y = pos_ENU[1];
+
+    position_x_ENU_from_NED(target.spray_left_x, target.spray_left_y, target.spray_left_z, pos_ENU);
+    ctx.setpoint_L.pose.position.x = pos_ENU[0];
+    ctx.setpoint_L.pose.position.y = pos_ENU[1];
+
+    position_x_ENU_from_NED(target.spray_right_x, target.spray_right_y, target.spray_right_z, pos_ENU);
+    ctx.setpoint_R.pose.position.x = pos_ENU[0];
+    ctx.setpoint_R.pose.position.y = pos_ENU[1];
+
+    /* calculate yaw*. -libn */
+    float deta_x = ctx.setpoint_R.pose.position.x - ctx.setpoint_L.pose.position.x;
+    float deta_y = ctx.setpoint_R.pose.position.y - ctx.setpoint_L.pose.position.y;
+    ctx.yaw_sp = wrap_pi(atan2(deta_y,deta_x) + M_PI/2);    /* yaw* in ENU in rad within [-pi,pi]. */
+
+    /* yaw* for controller. */
+    ctx.pose_pub.pose.orientation.x = 0;			/* orientation expressed using quaternion. -libn */
+    ctx.pose_pub.pose.orientation.y = 0;			/* w = cos(theta/2), x = nx * sin(theta/2),  y = ny * sin(theta/2), z = nz * sin(theta/2) -libn */
+    ctx.pose_pub.pose.orientation.z = sin(ctx.yaw_sp/2);
+    ctx.pose_pub.pose.orientation.w = cos(ctx.yaw_sp/2);
+}
@@ -0,0 +1,651 @@
+/**
+* @file     : mission_benchmark.cpp
+* @brief    : micro-benchmark of the hot paths: mission tick in every mission state, board_pos_cb
+*             (BoardDetector) for 0..10 detections and fixed_target_position_p2m_cb.
+*             per call latency(p50/p99) and heap allocations are measured.
+*             usage: mission_benchmark [--save FILE] [--compare FILE] [--iterations N]
+*             --save stores the results as baseline, --compare prints the change against a stored
+*             baseline and returns 1 on regression(p50 > REGRESSION_RATIO * baseline or more allocations).
+*             returns 1 as well if a control hot path case(tick, callback) allocates in steady state,
+*             checked by ctest(mission_benchmark_allocations).
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/mission.h>
+#include <state_machine/mission_harness.h>
+#include <state_machine/board_detector.h>
+#include <state_machine/board_mirror.h>
+#include <state_machine/pose_history.h>
+#include <state_machine/vehicle_state.h>
+#include <state_machine/seqlock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REGRESSION_RATIO 1.25   /* p50 slower than baseline by more than 25% -> regression. */
+
+/* ---------------------------------------------------------------- allocation counter */
+
+static std::atomic<unsigned long> allocations(0);
+
+/* not inlined: callers must not see the malloc/free pair behind new/delete. */
+__attribute__((noinline)) void* operator new(std::size_t size)
+{
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if(!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+/* ---------------------------------------------------------------- measurement */
+
+struct BenchResult
+{
+    std::string name;
+    double p50;         /* ns per call. */
+    double p99;
+    double allocs;      /* heap allocations per call. */
+    int items;          /* detections per call, 0: not counted. */
+};
+
+/* setup(i) is run before every call and not measured, call(i) is measured. */
+template <typename Setup, typename Call>
+static BenchResult measure(const std::string& name, int iterations, Setup setup, Call call)
+{
+    std::vector<double> ns(iterations);
+    unsigned long allocs = 0;
+    for(int i = 0; i < iterations; ++i)
+    {
+        setup(i);
+        unsigned long a = allocations;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        call(i);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        allocs += allocations - a;
+        ns[i] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+    std::sort(ns.begin(), ns.end());
+
+    BenchResult r;
+    r.name = name;
+    r.p50 = ns[iterations / 2];
+    r.p99 = ns[(size_t)(iterations * 0.99)];
+    r.allocs = (double)allocs / iterations;
+    r.items = 0;
+    return r;
+}
+
+/* ---------------------------------------------------------------- cases */
+
+struct StateName
+{
+    int id;
+    const char* name;
+};
+
+static const StateName mission_state_names[] =
+{
+    {takeoff,                           "takeoff"},
+    {mission_hover_after_takeoff,       "hover_after_takeoff"},
+    {mission_scan_left_go,              "scan_left_go"},
+    {mission_scan_right_move,           "scan_right_move"},
+    {mission_scan_right_hover,          "scan_right_hover"},
+    {mission_scan_left_move,            "scan_left_move"},
+    {mission_scan_left_hover,           "scan_left_hover"},
+    {mission_scan_sweep_right,          "scan_sweep_right"},
+    {mission_scan_sweep_left,           "scan_sweep_left"},
+    {mission_observe_point_go,          "observe_point_go"},
+    {mission_observe_num_wait,          "observe_num_wait"},
+    {mission_num_search,                "num_search"},
+    {mission_num_locate,                "num_locate"},
+    {mission_num_get_close,             "num_get_close"},
+    {mission_hover_before_spary,        "hover_before_spary"},
+    {mission_arm_spread,                "arm_spread"},
+    {mission_num_hover_spray,           "num_hover_spray"},
+    {mission_hover_after_stretch_back,  "hover_after_stretch_back"},
+    {mission_num_done,                  "num_done"},
+    {mission_fix_failure,               "fix_failure"},
+    {mission_force_return_home,         "force_return_home"},
+    {mission_return_home,               "return_home"},
+    {mission_hover_only,                "hover_only"},
+    {land,                              "land"},
+};
+
+/* mission tick(action, guards, timers) in every state, context taken from the middle of a
+ * simulated mission so that boards are known and timers are running. */
+static void bench_mission_tick(int iterations, std::vector<BenchResult>& results)
+{
+    MissionHarness harness(harness_default_config());
+    for(int i = 0; i < 200; ++i)    /* 20s: takeoff and scan done. */
+    {
+        harness.step();
+    }
+    const MissionContext base = harness.context();
+    MissionContext ctx = base;
+    OffbMissionEngine engine = mission_engine(takeoff);
+
+    for(size_t s = 0; s < sizeof(mission_state_names) / sizeof(mission_state_names[0]); ++s)
+    {
+        const StateName& state = mission_state_names[s];
+        results.push_back(measure(std::string("tick/") + state.name, iterations,
+            [&](int i)
+            {
+                ctx.now = base.now + ros::Duration(0.1 * (i % 100));
+                ctx.mission_last_time = base.now;
+                ctx.loop = base.loop;
+                engine.force(state.id);
+            },
+            [&](int)
+            {
+                engine.tick(ctx);
+                mission_timers(ctx, engine);
+            }));
+    }
+}
+
+#define BOARD_BENCH_MAP 500     /* boards mapped in the large map case. */
+
+/* board_pos_cb of get_board_position: message copy, pose at capture time and BoardDetector, n detections. */
+static void bench_board_pos_cb(int iterations, std::vector<BenchResult>& results)
+{
+    /* full pose history, 50Hz, image captured 0.1s before the latest pose. */
+    PoseHistory history;
+    pose_history_reset(history);
+    for(int i = 0; i < POSE_HISTORY_SIZE; ++i)
+    {
+        geometry_msgs::Point p;
+        p.x = 1.0 + 0.04 * i;
+        p.y = 2.0;
+        p.z = 1.5;
+        pose_history_push(history, ros::Time(10.0 + 0.02 * i), p);
+    }
+    const ros::Time capture(10.0 + 0.02 * (POSE_HISTORY_SIZE - 1) - 0.1);
+
+    for(int n = 0; n <= 10; ++n)
+    {
+        sensor_msgs::LaserScan msg;
+        msg.ranges.resize(n > 0 ? n * 4 : 4, 0.0f);
+        for(int i = 0; i < n; ++i)
+        {
+            msg.ranges[i*4] = (float)i;
+            msg.ranges[i*4 + 1] = 0.5f * i;
+            msg.ranges[i*4 + 2] = 3.0f;
+            msg.ranges[i*4 + 3] = -0.3f;
+        }
+        if(n == 0)
+        {
+            msg.ranges[0] = 11;     /* incomplete rectangle only. */
+        }
+
+        BoardDetector detector;
+        sensor_msgs::LaserScan board_scan;
+        char name[32];
+        snprintf(name, sizeof(name), "board_pos_cb/%d", n);
+        results.push_back(measure(name, iterations,
+            [&](int) {},
+            [&](int)
+            {
+                board_scan = msg;
+                geometry_msgs::Point pos;
+                pose_history_at(history, capture, pos);
+                detector.update(2, board_scan, pos);
+            }));
+    }
+
+    /* board_detections_cb: same detections in the typed message, read in place. */
+    for(int n = 0; n <= 10; ++n)
+    {
+        state_machine::BoardDetections msg;
+        msg.num = -1;
+        msg.detections.resize(n);
+        for(int i = 0; i < n; ++i)
+        {
+            state_machine::BoardDetection& detection = msg.detections[i];
+            detection.id = i;
+            detection.x = (int16_t)(500 * i);
+            detection.y = 3000;
+            detection.z = -300;
+            detection.confidence = 255;
+            detection.sigma[0] = detection.sigma[1] = detection.sigma[2] = 0;
+        }
+
+        BoardDetector detector;
+        char name[32];
+        snprintf(name, sizeof(name), "board_detections_cb/%d", n);
+        results.push_back(measure(name, iterations,
+            [&](int) {},
+            [&](int)
+            {
+                geometry_msgs::Point pos;
+                pose_history_at(history, capture, pos);
+                detector.update(2, msg, pos);
+            }));
+    }
+
+    /* vision_one_num_get: one num read voted, window full. */
+    {
+        sensor_msgs::LaserScan num;
+        num.ranges.resize(4, 0.0f);
+        num.ranges[1] = num.ranges[2] = 200.0f;     /* no position. */
+        BoardDetector detector;
+        sensor_msgs::LaserScan board_scan;
+        results.push_back(measure("board_pos_cb/num", iterations,
+            [&](int i) { num.ranges[0] = (float)(i % 7 == 0 ? 8 : 3); },
+            [&](int)
+            {
+                board_scan = num;
+                geometry_msgs::Point pos;
+                pose_history_at(history, capture, pos);
+                detector.update(1, board_scan, pos);
+            }));
+    }
+
+    /* 10 detections with BOARD_BENCH_MAP boards mapped: cost per detection must not grow with the map. */
+    /* ids above 9: typed message only(vision_num_scan reads 0..9). */
+    BoardDetector detector;
+    geometry_msgs::Point origin;
+    state_machine::BoardDetections one;
+    one.num = -1;
+    one.detections.resize(1);
+    for(int id = 0; id < BOARD_BENCH_MAP; ++id)
+    {
+        if(id == BOARD_NUM_INCOMPLETE)
+        {
+            continue;
+        }
+        state_machine::BoardDetection& detection = one.detections[0];
+        detection.id = id;
+        detection.x = (int16_t)(1000 * (id % 25));
+        detection.y = (int16_t)(1000 * (id / 25));
+        detection.z = 1200;
+        detection.confidence = 255;
+        detection.sigma[0] = detection.sigma[1] = detection.sigma[2] = 0;
+        for(int k = 0; k < 8; ++k)
+        {
+            detector.update(2, one, origin);
+        }
+    }
+    state_machine::BoardDetections msg;
+    msg.num = -1;
+    msg.detections.resize(10);
+    for(int i = 0; i < 10; ++i)
+    {
+        int id = 300 + i;
+        state_machine::BoardDetection& detection = msg.detections[i];
+        detection.id = id;
+        detection.x = (int16_t)(1000 * (id % 25));
+        detection.y = (int16_t)(1000 * (id / 25));
+        detection.z = 1200;
+        detection.confidence = 255;
+        detection.sigma[0] = detection.sigma[1] = detection.sigma[2] = 0;
+    }
+    char name[40];
+    snprintf(name, sizeof(name), "board_detections_cb/10_of_%d", BOARD_BENCH_MAP);
+    results.push_back(measure(name, iterations,
+        [&](int) {},
+        [&](int)
+        {
+            detector.update(2, msg, origin);
+        }));
+}
+
+/* batch ingest: board_detections_cb with n detections of boards mapped already, and the kernel alone
+ * (transform and gating of a full batch). counted in detections/s. */
+static void bench_ingest(int iterations, std::vector<BenchResult>& results)
+{
+    static const int sizes[] = {16, 64, 256};
+    for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        const int n = sizes[s];
+        state_machine::BoardDetections msg;
+        msg.num = -1;
+        msg.detections.resize(n);
+        for(int i = 0; i < n; ++i)
+        {
+            state_machine::BoardDetection& detection = msg.detections[i];
+            detection.id = i == BOARD_NUM_INCOMPLETE ? n : i;
+            detection.x = (int16_t)(500 * (i % 16));
+            detection.y = (int16_t)(500 * (i / 16));
+            detection.z = -300;
+            detection.confidence = 200;
+            detection.sigma[0] = detection.sigma[1] = detection.sigma[2] = (i & 1) ? 10 : 0;
+        }
+        BoardDetector detector;
+        geometry_msgs::Point origin;
+        detector.update(2, msg, origin);    /* boards mapped, board10 entries allocated. */
+
+        char name[32];
+        snprintf(name, sizeof(name), "ingest/%d", n);
+        results.push_back(measure(name, iterations,
+            [&](int) {},
+            [&](int)
+            {
+                detector.update(2, msg, origin);
+            }));
+        results.back().items = n;
+    }
+
+    DetectionBatch batch;
+    detection_batch_clear(batch);
+    for(int i = 0; i < DETECTION_BATCH_MAX; ++i)
+    {
+        detection_batch_push(batch, i, 0.5 * (i % 16), 0.5 * (i / 16), -0.3, 0.8, (i & 1) ? 0.01 : -1.0, -1.0, -1.0);
+        for(int a = 0; a < 3; ++a)
+        {
+            batch.x[a][i] = 0.1 * a;
+            batch.var[a][i] = 0.01;
+        }
+    }
+    const double pos[3] = {1.0, 2.0, 1.5};
+    char name[32];
+    snprintf(name, sizeof(name), "ingest_kernel/%d", DETECTION_BATCH_MAX);
+    results.push_back(measure(name, iterations,
+        [&](int) {},
+        [&](int)
+        {
+            detection_batch_transform(batch, pos, BOARD_SIGMA_MEASUREMENT, BOARD_RANGE_NOMINAL);
+            detection_batch_gate(batch, BOARD_SIGMA_PROCESS * BOARD_SIGMA_PROCESS);
+        }));
+    results.back().items = DETECTION_BATCH_MAX;
+}
+
+/* fixed_target_position_p2m_cb of offb_simulation_test without publishing. */
+static void bench_fixed_target_cb(int iterations, std::vector<BenchResult>& results)
+{
+    MissionContext ctx;
+    ctx.now = ros::Time(1.0);
+    mission_init(ctx);
+    state_machine::FIXED_TARGET_POSITION_P2M msg;
+    msg.home_x = 0.0f;      msg.home_y = 0.0f;      msg.home_z = 0.0f;
+    msg.observe_x = 2.0f;   msg.observe_y = 0.0f;   msg.observe_z = -1.4f;
+    msg.spray_left_x = 6.0f; msg.spray_left_y = -4.0f; msg.spray_left_z = -1.6f;
+    msg.spray_right_x = 6.0f; msg.spray_right_y = 4.0f; msg.spray_right_z = -1.6f;
+    state_machine::FIXED_TARGET_POSITION_P2M data;
+    state_machine::FIXED_TARGET_RETURN_M2P ret;
+
+    results.push_back(measure("fixed_target_cb", iterations,
+        [&](int) {},
+        [&](int)
+        {
+            data = msg;
+            mission_fixed_targets(ctx, data, ret);
+        }));
+}
+
+/* offb_simulation_test callbacks feeding the mission: pose, velocity, state and board positions. */
+static void bench_callbacks(int iterations, std::vector<BenchResult>& results)
+{
+    /* callbacks: message -> snapshot -> seqlock write, as in offb_simulation_test. */
+    geometry_msgs::PoseStamped pose;
+    pose.header.frame_id = "fcu_local_position_frame";  /* longer than any small string buffer. */
+    pose.pose.position.x = 1.0;
+    Seqlock<PoseSnapshot> pos_seqlock;
+    results.push_back(measure("callback/pos", iterations,
+        [&](int i) { pose.header.stamp = ros::Time(1.0 + i * 0.02); },
+        [&](int) {
+            PoseSnapshot snapshot;
+            pose_snapshot(snapshot, pose);
+            pos_seqlock.write(snapshot);
+        }));
+
+    geometry_msgs::TwistStamped vel;
+    vel.header.frame_id = "fcu_local_position_frame";
+    vel.twist.linear.z = 0.5;
+    Seqlock<VelocitySnapshot> vel_seqlock;
+    results.push_back(measure("callback/vel", iterations,
+        [&](int i) { vel.header.stamp = ros::Time(1.0 + i * 0.02); },
+        [&](int) {
+            VelocitySnapshot snapshot;
+            velocity_snapshot(snapshot, vel);
+            vel_seqlock.write(snapshot);
+        }));
+
+    Seqlock<VehicleState> state_seqlock;
+    state_machine::State state;
+    state.connected = true;
+    state.armed = true;
+    state.mode = "AUTO.TAKEOFF";    /* last entry of the mode table. */
+    results.push_back(measure("callback/state", iterations,
+        [&](int) {},
+        [&](int) {
+            VehicleState vehicle;
+            vehicle_state_update(vehicle, state);
+            state_seqlock.write(vehicle);
+        }));
+
+    state_machine::DrawingBoard10 board10;
+    board10.drawingboard.resize(10);
+    for(int i = 0; i < 10; ++i)
+    {
+        board10.drawingboard[i].num = i;
+        board10.drawingboard[i].x = i;
+        board10.drawingboard[i].y = 6.0f;
+        board10.drawingboard[i].z = 1.2f;
+        board10.drawingboard[i].valid = true;
+    }
+    Seqlock<BoardSnapshots> board_seqlock;
+    results.push_back(measure("callback/board10", iterations,
+        [&](int) {},
+        [&](int) {
+            BoardSnapshots boards;
+            boards_snapshot(boards, board10);
+            board_seqlock.write(boards);
+        }));
+
+    /* board map deltas: stable map(empty delta), one board changed per message. */
+    BoardMirror mirror;
+    board_mirror_reset(mirror);
+    state_machine::BoardMapDelta delta;
+    delta.seq = 0;
+    delta.keyframe = true;
+    delta.boards = board10.drawingboard;
+    for(int i = 0; i < 10; ++i)
+    {
+        delta.boards[i].version = 1;
+    }
+    board_mirror_apply(mirror, delta);
+    state_machine::BoardMapDelta stable;
+    stable.seq = 0;
+    stable.keyframe = false;
+    results.push_back(measure("callback/board_delta/0", iterations,
+        [&](int) { stable.seq = ++delta.seq; },
+        [&](int) {
+            if(board_mirror_apply(mirror, stable))
+            {
+                board_seqlock.write(mirror.boards);
+            }
+        }));
+    state_machine::BoardMapDelta one;
+    one.keyframe = false;
+    one.boards.resize(1);
+    one.boards[0] = delta.boards[3];
+    results.push_back(measure("callback/board_delta/1", iterations,
+        [&](int) { one.seq = ++delta.seq; one.boards[0].version++; },
+        [&](int) {
+            if(board_mirror_apply(mirror, one))
+            {
+                board_seqlock.write(mirror.boards);
+            }
+        }));
+
+    /* control loop side: one read of every snapshot per stream cycle. */
+    MissionContext ctx;
+    ctx.now = ros::Time(1.0);
+    mission_init(ctx);
+    uint32_t epoch = 0;
+    results.push_back(measure("callback/snapshot_read", iterations,
+        [&](int) {},
+        [&](int) {
+            VehicleState vehicle;
+            BoardSnapshots boards;
+            state_seqlock.read(vehicle);
+            pos_seqlock.read(ctx.current_pos);
+            vel_seqlock.read(ctx.current_vel);
+            board_seqlock.read(boards);
+            board_mirror_copy(boards, ctx.board, epoch);
+        }));
+}
+
+/* control hot path: must not allocate once running. */
+static bool hot_path(const std::string& name)
+{
+    return name.compare(0, 5, "tick/") == 0 || name.compare(0, 9, "callback/") == 0;
+}
+
+/* ---------------------------------------------------------------- baseline */
+
+static bool save_baseline(const char* file, const std::vector<BenchResult>& results)
+{
+    FILE* f = fopen(file, "w");
+    if(!f)
+    {
+        fprintf(stderr, "cannot write baseline %s\n", file);
+        return false;
+    }
+    fprintf(f, "# name p50_ns p99_ns allocs_per_call\n");
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        fprintf(f, "%s %.1f %.1f %.2f\n", results[i].name.c_str(), results[i].p50, results[i].p99, results[i].allocs);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool load_baseline(const char* file, std::map<std::string, BenchResult>& baseline)
+{
+    FILE* f = fopen(file, "r");
+    if(!f)
+    {
+        fprintf(stderr, "cannot read baseline %s\n", file);
+        return false;
+    }
+    char line[256];
+    while(fgets(line, sizeof(line), f))
+    {
+        char name[128];
+        BenchResult r;
+        if(line[0] == '#' || sscanf(line, "%127s %lf %lf %lf", name, &r.p50, &r.p99, &r.allocs) != 4)
+        {
+            continue;
+        }
+        r.name = name;
+        baseline[r.name] = r;
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char* save_file = NULL;
+    const char* compare_file = NULL;
+    int iterations = 20000;
+    for(int i = 1; i < argc; ++i)
+    {
+        if(strcmp(argv[i], "--save") == 0 && i + 1 < argc)              save_file = argv[++i];
+        else if(strcmp(argv[i], "--compare") == 0 && i + 1 < argc)      compare_file = argv[++i];
+        else if(strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)   iterations = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: mission_benchmark [--save FILE] [--compare FILE] [--iterations N]\n");
+            return 1;
+        }
+    }
+    if(iterations < 100)
+    {
+        iterations = 100;
+    }
+
+    std::map<std::string, BenchResult> baseline;
+    if(compare_file && !load_baseline(compare_file, baseline))
+    {
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    bench_mission_tick(iterations, results);
+    bench_board_pos_cb(iterations, results);
+    bench_ingest(iterations, results);
+    bench_fixed_target_cb(iterations, results);
+    bench_callbacks(iterations, results);
+
+    int regressions = 0;
+    int allocating = 0;
+    printf("%-32s %10s %10s %8s", "case", "p50(ns)", "p99(ns)", "allocs");
+    if(compare_file)
+    {
+        printf(" %10s", "p50 change");
+    }
+    printf("\n");
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& r = results[i];
+        printf("%-32s %10.1f %10.1f %8.2f", r.name.c_str(), r.p50, r.p99, r.allocs);
+        if(hot_path(r.name) && r.allocs > 0)
+        {
+            printf("  ALLOCATES");
+            allocating++;
+        }
+        if(compare_file)
+        {
+            std::map<std::string, BenchResult>::const_iterator b = baseline.find(r.name);
+            if(b == baseline.end())
+            {
+                printf(" %10s", "new");
+            }
+            else
+            {
+                printf(" %+9.1f%%", b->second.p50 > 0 ? 100.0 * (r.p50 / b->second.p50 - 1.0) : 0.0);
+                if(r.p50 > REGRESSION_RATIO * b->second.p50 || r.allocs > b->second.allocs + 0.005)
+                {
+                    printf("  REGRESSION");
+                    regressions++;
+                }
+            }
+        }
+        printf("\n");
+    }
+
+    printf("\ningest kernel: %s\n", detection_batch_isa());
+    for(size_t i = 0; i < results.size(); ++i)
+    {
+        if(results[i].items > 0 && results[i].p50 > 0)
+        {
+            printf("%-32s %10.2f Mdetections/s\n", results[i].name.c_str(), results[i].items * 1e3 / results[i].p50);
+        }
+    }
+
+    if(save_file && !save_baseline(save_file, results))
+    {
+        return 1;
+    }
+    if(allocating)
+    {
+        printf("%d hot path case(s) allocate\n", allocating);
+        return 1;
+    }
+    if(regressions)
+    {
+        printf("%d regression(s) against %s\n", regressions, compare_file);
+        return 1;
+    }
+    return 0;
+}
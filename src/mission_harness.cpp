@@ -0,0 +1,336 @@
+/**
+* @file     : mission_harness.cpp
+* @brief    : headless lockstep harness of the offb mission.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/mission_harness.h>
+
+#include <algorithm>
+
+#include <math.h>
+
+#define HARNESS_KEYFRAME_PERIOD 1.0     /* board map keyframe(s), ~board_keyframe_period of get_board_position. */
+
+static geometry_msgs::Point point(double x, double y, double z)
+{
+    geometry_msgs::Point p;
+    p.x = x;
+    p.y = y;
+    p.z = z;
+    return p;
+}
+
+HarnessConfig harness_default_config(void)
+{
+    HarnessConfig config;
+    config.tick_period = 1.0/ROS_RATE;
+    config.pose_per_tick = 5;   /* local position at 50Hz. */
+    config.time_limit = MAX_FLIGHT_TIME + 5 * 30.0 + 60.0;
+    config.event_driven = true;
+
+    config.vehicle_tau = 0.4;
+    config.max_speed = 2.0;
+    config.max_acceleration = 3.0;
+    config.trajectory = trajectory_default_limits(1.0/ROS_RATE);
+    config.feed_forward = true;
+
+    /* yaw* = 90 degree(ENU): boards to the north of home. */
+    config.home = point(0.0, 0.0, 0.0);
+    config.setpoint_L = point(-4.0, 6.0, SCAN_HEIGHT);
+    config.setpoint_R = point(4.0, 6.0, SCAN_HEIGHT);
+    config.setpoint_A = point(0.0, 2.0, FIXED_POS_HEIGHT);
+    config.yaw_sp = 90*M_PI/180;
+    for(int i = 0; i < 10; ++i)
+    {
+        config.board[i].num = i;
+        config.board[i].x = -4.5 + i;
+        config.board[i].y = 6.0;
+        config.board[i].z = 1.2;
+        config.board[i].valid = true;
+    }
+
+    config.vision_range = 10.0;
+    config.background_mapping = true;
+    config.mission_num[0] = 0;  /* loop 0 is scanning. */
+    config.mission_num[1] = 3;
+    config.mission_num[2] = 7;
+    config.mission_num[3] = 1;
+    config.mission_num[4] = 9;
+    config.mission_num[5] = 5;
+
+    config.seed = 0;
+    config.vision_noise = 0.0;
+    config.vision_dropout = 0.0;
+    config.num_misread = 0.0;
+    config.wind = 0.0;
+    return config;
+}
+
+MissionHarness::MissionHarness(const HarnessConfig& config)
+    : config_(config),
+      engine_(mission_engine(takeoff)),
+      streamer_(config.trajectory),
+      rng_(config.seed)
+{
+    ctx_.current_pos.position = config_.home;
+    ctx_.current_vel.linear = geometry_msgs::Vector3();
+    ctx_.current_pos.stamp = clock_.now();
+    ctx_.current_vel.stamp = clock_.now();
+    ctx_.now = clock_.now();
+    mission_init(ctx_);
+
+    /* setpoints and yaw* as sent by send4setpoint. */
+    ctx_.setpoint_A.pose.position.x = config_.setpoint_A.x;
+    ctx_.setpoint_A.pose.position.y = config_.setpoint_A.y;
+    ctx_.setpoint_L.pose.position.x = config_.setpoint_L.x;
+    ctx_.setpoint_L.pose.position.y = config_.setpoint_L.y;
+    ctx_.setpoint_R.pose.position.x = config_.setpoint_R.x;
+    ctx_.setpoint_R.pose.position.y = config_.setpoint_R.y;
+    ctx_.yaw_sp = config_.yaw_sp;
+
+    disturbance_ = geometry_msgs::Vector3();
+    vehicle_vel_ = geometry_msgs::Vector3();
+    BoardMappingConfig mapping = board_mapping_default_config();
+    mapping.background = config_.background_mapping;
+    detector_.set_mapping(mapping);
+    detections_.detections.reserve(10);
+    last_keyframe_ = clock_.now();
+    board_mirror_reset(mirror_);
+    board_epoch_ = 0;
+    boards_pending_ = false;
+    streamer_.reset(ctx_.current_pos.position, clock_.now());
+    start_time_ = clock_.now();
+
+    result_.landed = false;
+    result_.flight_time = 0.0;
+    result_.loop_timeouts = 0;
+    result_.failures = 0;
+    result_.failures_max = 0;
+    result_.sprays = 0;
+    result_.spray_time = 0.0;
+    result_.spray_latency = 0.0;
+    result_.ticks = 0;
+}
+
+HarnessResult MissionHarness::run(void)
+{
+    while(step())
+    {
+    }
+    return result_;
+}
+
+bool MissionHarness::step(void)
+{
+    if(engine_.state() == land || result_.flight_time > config_.time_limit)
+    {
+        return false;
+    }
+
+    const double dt = config_.tick_period / config_.pose_per_tick;
+    for(int i = 0; i < config_.pose_per_tick; ++i)
+    {
+        clock_.advance(dt);
+        vehicle_update(dt);
+        ctx_.current_pos.stamp = clock_.now();
+        ctx_.current_vel.stamp = clock_.now();
+        vision_update();
+        mission_spray_stream(ctx_, clock_.now());
+        if(config_.event_driven)
+        {
+            ctx_.now = clock_.now();
+            if(engine_.react(ctx_, MISSION_EVENT_POSE))
+            {
+                setpoint_update();
+            }
+        }
+    }
+
+    ctx_.now = clock_.now();
+    int last_state = engine_.state();
+    engine_.tick(ctx_);
+    mission_timers(ctx_, engine_);
+    setpoint_update();
+    if(engine_.state() == mission_num_hover_spray && last_state != mission_num_hover_spray)
+    {
+        result_.sprays++;
+    }
+
+    result_.ticks++;
+    result_.flight_time = (clock_.now() - start_time_).toSec();
+    result_.loop_timeouts = ctx_.loop_timeout_count;
+    result_.failures = ctx_.retry.count;
+    result_.failures_max = std::max(result_.failures_max, result_.failures);
+    result_.spray_time = 0.0;
+    result_.spray_latency = 0.0;
+    for(int i = 0; i < BOARD_NUM_MAX; ++i)
+    {
+        if(ctx_.spray_record[i].count > 0)
+        {
+            result_.spray_time += ctx_.spray_record[i].sprayed;
+            result_.spray_latency += ctx_.spray_record[i].latency;
+        }
+    }
+    result_.landed = engine_.state() == land;
+    return !result_.landed;
+}
+
+void MissionHarness::setpoint_update(void)
+{
+    if(ctx_.velocity_control_enable)
+    {
+        streamer_.reset(ctx_.current_pos.position, ctx_.current_vel.linear, clock_.now());
+    }
+    else
+    {
+        streamer_.set_target(ctx_.pose_pub.pose.position, clock_.now());
+    }
+}
+
+void MissionHarness::vehicle_update(double dt)
+{
+    geometry_msgs::Point& pos = ctx_.current_pos.position;
+    geometry_msgs::Vector3& vel = ctx_.current_vel.linear;
+
+    geometry_msgs::Vector3 cmd;
+    if(ctx_.velocity_control_enable)
+    {
+        cmd = ctx_.vel_pub.twist.linear;
+    }
+    else
+    {
+        TrajectoryState sp = streamer_.sample_state(clock_.now());
+        cmd.x = (sp.position.x - pos.x) / config_.vehicle_tau;
+        cmd.y = (sp.position.y - pos.y) / config_.vehicle_tau;
+        cmd.z = (sp.position.z - pos.z) / config_.vehicle_tau;
+        if(config_.feed_forward)
+        {
+            cmd.x += sp.velocity.x;
+            cmd.y += sp.velocity.y;
+            cmd.z += sp.velocity.z;
+        }
+        double speed = sqrt(cmd.x*cmd.x + cmd.y*cmd.y + cmd.z*cmd.z);
+        if(speed > config_.max_speed)
+        {
+            cmd.x *= config_.max_speed / speed;
+            cmd.y *= config_.max_speed / speed;
+            cmd.z *= config_.max_speed / speed;
+        }
+    }
+
+    /* velocity follows the command within max_acceleration: a step target overshoots. */
+    geometry_msgs::Vector3 dv;
+    dv.x = cmd.x - vehicle_vel_.x;
+    dv.y = cmd.y - vehicle_vel_.y;
+    dv.z = cmd.z - vehicle_vel_.z;
+    double dv_norm = sqrt(dv.x*dv.x + dv.y*dv.y + dv.z*dv.z);
+    double dv_max = config_.max_acceleration * dt;
+    if(config_.max_acceleration > 0.0 && dv_norm > dv_max)
+    {
+        dv.x *= dv_max / dv_norm;
+        dv.y *= dv_max / dv_norm;
+        dv.z *= dv_max / dv_norm;
+    }
+    vehicle_vel_.x += dv.x;
+    vehicle_vel_.y += dv.y;
+    vehicle_vel_.z += dv.z;
+    vel = vehicle_vel_;
+
+    /* wind: first order gauss-markov disturbance(correlation time 2s), not while on ground. */
+    if(config_.wind > 0.0 && pos.z > 0.1)
+    {
+        const double beta = dt / 2.0;
+        std::normal_distribution<double> gust(0.0, config_.wind * sqrt(2.0 * beta));
+        disturbance_.x += -beta * disturbance_.x + gust(rng_);
+        disturbance_.y += -beta * disturbance_.y + gust(rng_);
+        disturbance_.z += -beta * disturbance_.z + gust(rng_);
+        vel.x += disturbance_.x;
+        vel.y += disturbance_.y;
+        vel.z += disturbance_.z;
+    }
+
+    pos.x += vel.x * dt;
+    pos.y += vel.y * dt;
+    pos.z += vel.z * dt;
+}
+
+void MissionHarness::vision_update(void)
+{
+    if(config_.vision_dropout > 0.0 &&
+       std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < config_.vision_dropout)
+    {
+        return;     /* frame lost. */
+    }
+
+    /* vision frame: num read(vision_one_num_get), boards in range relative to the vehicle. */
+    detections_.num = -1;
+    if(ctx_.camera_switch == 1)
+    {
+        int num = config_.mission_num[ctx_.loop < 6 ? ctx_.loop : 5];
+        if(config_.num_misread > 0.0 &&
+           std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < config_.num_misread)
+        {
+            num = (num + std::uniform_int_distribution<int>(1, 9)(rng_)) % 10;
+        }
+        detections_.num = num;
+    }
+    const geometry_msgs::Point& pos = ctx_.current_pos.position;
+    detections_.detections.clear();
+    for(int i = 0; i < 10; ++i)
+    {
+        const state_machine::DrawingBoard& board = config_.board[i];
+        if(!board.valid || circle_distance(pos.x, board.x, pos.y, board.y, pos.z, board.z) >= config_.vision_range)
+        {
+            continue;
+        }
+        double d[3] = {board.x - pos.x, board.y - pos.y, board.z - pos.z};
+        if(config_.vision_noise > 0.0)
+        {
+            std::normal_distribution<double> noise(0.0, config_.vision_noise);
+            for(int k = 0; k < 3; ++k)
+            {
+                d[k] += noise(rng_);
+            }
+        }
+        state_machine::BoardDetection detection;
+        detection.id = board.num;
+        detection.x = (int16_t)lround(d[0] / BOARD_DETECTION_POSITION_SCALE);
+        detection.y = (int16_t)lround(d[1] / BOARD_DETECTION_POSITION_SCALE);
+        detection.z = (int16_t)lround(d[2] / BOARD_DETECTION_POSITION_SCALE);
+        detection.confidence = 255;
+        detection.sigma[0] = detection.sigma[1] = detection.sigma[2] = 0;     /* range model. */
+        detections_.detections.push_back(detection);
+    }
+
+    /* get_board_position: num voted, board map deltas. */
+    unsigned updated = detector_.update(ctx_.camera_switch, detections_, pos);
+    if(updated & BOARD_NUM_UPDATED)
+    {
+        ctx_.current_mission_num = detector_.num();
+        ctx_.num_confidence = detector_.voter().confidence;
+    }
+    bool keyframe = (clock_.now() - last_keyframe_).toSec() >= HARNESS_KEYFRAME_PERIOD;
+    if((updated & BOARD_POSITION_UPDATED) || keyframe)
+    {
+        detector_.delta(delta_, keyframe);
+        if(keyframe)
+        {
+            last_keyframe_ = clock_.now();
+        }
+        if(board_mirror_apply(mirror_, delta_))
+        {
+            boards_pending_ = true;
+        }
+    }
+
+    /* offb_simulation_test: no update while in operation(see snapshot_update). */
+    if(boards_pending_ &&
+       engine_.state() != mission_arm_spread &&
+       engine_.state() != mission_num_hover_spray)
+    {
+        board_mirror_copy(mirror_.boards, ctx_.board, board_epoch_);
+        boards_pending_ = false;
+    }
+}
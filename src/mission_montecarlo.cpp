@@ -0,0 +1,148 @@
+/**
+* @file     : mission_montecarlo.cpp
+* @brief    : batch simulator: runs randomized offb missions(board layout, vision noise, dropout, wind,
+*             num misreads) on all cores with MissionHarness and prints the distribution of the results.
+*             usage: mission_montecarlo [runs] [threads] [seed]
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/mission_harness.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* random field and disturbances of one run, reproducible from seed. */
+static HarnessConfig random_config(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    HarnessConfig config = harness_default_config();
+
+    /* board row: 10 boards between L and R, yaw* faces the row. */
+    const double yaw = 2 * M_PI * uniform(rng);
+    const double row_distance = 5.0 + 3.0 * uniform(rng);
+    const double row_length = 7.0 + 3.0 * uniform(rng);
+    const double cx = row_distance * cos(yaw), cy = row_distance * sin(yaw);
+    const double ux = sin(yaw), uy = -cos(yaw);     /* along the row, from L to R. */
+    config.yaw_sp = yaw;
+    config.setpoint_L.x = cx - ux * row_length / 2;
+    config.setpoint_L.y = cy - uy * row_length / 2;
+    config.setpoint_R.x = cx + ux * row_length / 2;
+    config.setpoint_R.y = cy + uy * row_length / 2;
+    config.setpoint_A.x = cx - 4.0 * cos(yaw);
+    config.setpoint_A.y = cy - 4.0 * sin(yaw);
+    for(int i = 0; i < 10; ++i)
+    {
+        const double s = row_length * ((i + 0.5) / 10.0 - 0.5) + 0.2 * (uniform(rng) - 0.5);
+        const double depth = 0.4 * (uniform(rng) - 0.5);
+        config.board[i].num = i;
+        config.board[i].x = cx + ux * s + depth * cos(yaw);
+        config.board[i].y = cy + uy * s + depth * sin(yaw);
+        config.board[i].z = 0.8 + 0.8 * uniform(rng);
+        config.board[i].valid = true;
+    }
+
+    /* 5 different nums, one per loop. */
+    int nums[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::shuffle(nums, nums + 10, rng);
+    config.mission_num[0] = nums[9];
+    for(int loop = 1; loop <= 5; ++loop)
+    {
+        config.mission_num[loop] = nums[loop - 1];
+    }
+
+    config.seed = rng();
+    config.vision_noise = 0.05 * uniform(rng);
+    config.vision_dropout = 0.3 * uniform(rng);
+    config.wind = 0.3 * uniform(rng);
+    config.num_misread = 0.2 * uniform(rng);
+    return config;
+}
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if(sorted.empty())
+    {
+        return 0.0;
+    }
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+int main(int argc, char **argv)
+{
+    const int runs = argc > 1 ? atoi(argv[1]) : 1000;
+    int threads = argc > 2 ? atoi(argv[2]) : (int)std::thread::hardware_concurrency();
+    const unsigned seed = argc > 3 ? (unsigned)atoi(argv[3]) : 1;
+    if(runs <= 0)
+    {
+        fprintf(stderr, "usage: mission_montecarlo [runs] [threads] [seed]\n");
+        return 1;
+    }
+    if(threads <= 0)
+    {
+        threads = 1;
+    }
+
+    /* results stored by run index: output does not depend on thread count. */
+    std::vector<HarnessResult> results(runs);
+    std::atomic<int> next(0);
+    std::vector<std::thread> workers;
+    for(int t = 0; t < threads; ++t)
+    {
+        workers.push_back(std::thread([&]()
+        {
+            for(int i = next++; i < runs; i = next++)
+            {
+                MissionHarness harness(random_config(seed + (unsigned)i));
+                results[i] = harness.run();
+            }
+        }));
+    }
+    for(size_t t = 0; t < workers.size(); ++t)
+    {
+        workers[t].join();
+    }
+
+    std::vector<double> times;
+    int landed = 0;
+    int timeouts[7] = {0};  /* loop timeouts: 0..5, 6: more. */
+    int failures[6] = {0};  /* largest retry queue. */
+    int failures_left[6] = {0};
+    int sprays[7] = {0};
+    for(int i = 0; i < runs; ++i)
+    {
+        const HarnessResult& r = results[i];
+        if(r.landed)
+        {
+            landed++;
+            times.push_back(r.flight_time);
+        }
+        timeouts[std::min(r.loop_timeouts, 6)]++;
+        failures[std::min(std::max(r.failures_max, 0), 5)]++;
+        failures_left[std::min(std::max(r.failures, 0), 5)]++;
+        sprays[std::min(r.sprays, 6)]++;
+    }
+    std::sort(times.begin(), times.end());
+
+    printf("runs: %d threads: %d seed: %u\n", runs, threads, seed);
+    printf("landed: %d(%.1f%%)\n", landed, 100.0 * landed / runs);
+    printf("completion time(s): min %.1f p5 %.1f p50 %.1f p95 %.1f max %.1f\n",
+           percentile(times, 0.0), percentile(times, 0.05), percentile(times, 0.5),
+           percentile(times, 0.95), percentile(times, 1.0));
+    printf("%-8s %10s %10s %10s %10s\n", "count", "timeouts", "failures", "unfixed", "sprays");
+    for(int n = 0; n <= 6; ++n)
+    {
+        printf("%-8d %10d %10d %10d %10d\n", n, timeouts[n],
+               n <= 5 ? failures[n] : 0, n <= 5 ? failures_left[n] : 0, sprays[n]);
+    }
+    return 0;
+}
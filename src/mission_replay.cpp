@@ -0,0 +1,55 @@
+/**
+* @file     : mission_replay.cpp
+* @brief    : replay the whole offb mission headless in lockstep and print the result.
+*             usage: mission_replay [tick-driven] [step] [no-feed-forward]
+*             step: setpoint jumps to each mission target(no trajectory).
+*             no-feed-forward: position setpoints only(PoseStamped).
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/mission_harness.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+int main(int argc, char **argv)
+{
+    HarnessConfig config = harness_default_config();
+    for(int i = 1; i < argc; ++i)
+    {
+        if(strcmp(argv[i], "tick-driven") == 0)
+        {
+            config.event_driven = false;
+        }
+        else if(strcmp(argv[i], "step") == 0)
+        {
+            config.trajectory.max_velocity = 0.0;
+        }
+        else if(strcmp(argv[i], "no-feed-forward") == 0)
+        {
+            config.feed_forward = false;
+        }
+    }
+
+    clock_t start = clock();
+    MissionHarness harness(config);
+    HarnessResult result = harness.run();
+    double wall = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("landed: %d\n", result.landed);
+    printf("flight time: %.2f s(mission time)\n", result.flight_time);
+    printf("sprays: %d loop timeouts: %d failures left: %d\n",
+           result.sprays, result.loop_timeouts, result.failures);
+    printf("spray time: %.2f s spray start latency: %.2f s(all boards)\n",
+           result.spray_time, result.spray_latency);
+    const MissionSchedule& schedule = harness.context().schedule;
+    printf("loops finished: %d deferred: %d skipped: %d loop estimate: %.1f s\n",
+           schedule.finished, schedule.deferred, schedule.skipped, schedule.loop_estimate);
+    const RetryQueue& retry = harness.context().retry;
+    printf("retries: failures %d started %d recovered %d dropped %d\n",
+           retry.recorded, retry.started, retry.recovered, retry.dropped);
+    printf("ticks: %d replayed in %.3f ms\n", result.ticks, wall * 1000.0);
+    return result.landed ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/**
+* @file     : mission_scheduler.cpp
+* @brief    : mission scheduler: flight and loop budgets, finish/defer/skip decisions, telemetry.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/mission_scheduler.h>
+#include <state_machine/mission.h>
+
+#include <math.h>
+
+ScheduleConfig schedule_default_config()
+{
+    ScheduleConfig config;
+    config.flight_budget = MAX_FLIGHT_TIME;
+    config.scan_cost = SCHEDULE_SCAN_COST;
+    config.loop_cost = SCHEDULE_LOOP_COST;
+    config.cruise_speed = 1.5;
+    config.move_overhead = 2.0;
+    config.land_cost = 5.0;
+    config.margin = 5.0;
+    config.learn_rate = 0.5;
+    return config;
+}
+
+void schedule_reset(MissionSchedule& schedule, const ScheduleConfig& config)
+{
+    schedule.started = false;
+    schedule.loop = 0;
+    schedule.repair = false;
+    schedule.elapsed = 0.0;
+    schedule.remaining = config.flight_budget;
+    schedule.loop_elapsed = 0.0;
+    schedule.loop_budget = config.scan_cost;
+    schedule.grace = -1.0;
+    schedule.loop_estimate = config.loop_cost;
+    schedule.task_left = 0.0;
+    schedule.home_cost = 0.0;
+    schedule.slack = 0.0;
+    schedule.decision = SCHEDULE_CONTINUE;
+    schedule.finished = 0;
+    schedule.deferred = 0;
+    schedule.skipped = 0;
+}
+
+void schedule_start(MissionSchedule& schedule, const ros::Time& now)
+{
+    if(!schedule.started)
+    {
+        schedule.started = true;
+        schedule.start = now;
+        schedule.loop_start = now;
+    }
+}
+
+double schedule_move_cost(const ScheduleConfig& config, double distance)
+{
+    return distance / config.cruise_speed + config.move_overhead;
+}
+
+/* board loops after the current one. */
+static int loops_after(int loop)
+{
+    if(loop < 0 || loop >= SCHEDULE_LOOPS)
+    {
+        return 0;
+    }
+    return SCHEDULE_LOOPS - (loop > 0 ? loop : 0);
+}
+
+double schedule_available(const MissionSchedule& schedule, const ScheduleConfig& config)
+{
+    return schedule.remaining - schedule.home_cost - config.margin;
+}
+
+static void new_loop(MissionSchedule& schedule, const ScheduleConfig& config, int loop, const ros::Time& now)
+{
+    /* board loop ended by the mission itself: learn its cost. */
+    bool board_loop = schedule.loop >= 1 && schedule.loop <= SCHEDULE_LOOPS;
+    if(board_loop && schedule.decision != SCHEDULE_DEFER && schedule.decision != SCHEDULE_SKIP)
+    {
+        double cost = (now - schedule.loop_start).toSec();
+        schedule.loop_estimate += config.learn_rate * (cost - schedule.loop_estimate);
+        schedule.finished++;
+    }
+    schedule.loop = loop;
+    schedule.loop_start = now;
+    schedule.grace = -1.0;
+    schedule.repair = false;
+
+    /* loop 0: fixed; board loops: fair share of what is left, at least the loop estimate. */
+    double left = schedule_available(schedule, config);
+    if(loop == 0)
+    {
+        schedule.loop_budget = config.scan_cost;
+    }
+    else if(loop <= SCHEDULE_LOOPS)
+    {
+        double share = left / (loops_after(loop) + 1);
+        schedule.loop_budget = fmin(left, fmax(schedule.loop_estimate, share));
+    }
+    else
+    {
+        schedule.loop_budget = left;    /* repairs. */
+    }
+}
+
+ScheduleDecision schedule_update(MissionSchedule& schedule, const ScheduleConfig& config, const ros::Time& now,
+                                 int loop, double task_left, double home_cost)
+{
+    if(!schedule.started)
+    {
+        schedule.decision = SCHEDULE_CONTINUE;
+        return schedule.decision;
+    }
+    schedule.elapsed = (now - schedule.start).toSec();
+    schedule.remaining = config.flight_budget - schedule.elapsed;
+    schedule.task_left = task_left;
+    schedule.home_cost = home_cost;
+    if(loop != schedule.loop)
+    {
+        new_loop(schedule, config, loop, now);
+    }
+    schedule.loop_elapsed = (now - schedule.loop_start).toSec();
+
+    double left = schedule_available(schedule, config);
+    double after = loops_after(loop) * schedule.loop_estimate;
+    schedule.slack = left - task_left - after;
+
+    if(left <= 0.0)
+    {
+        schedule.decision = SCHEDULE_RETURN_HOME;
+    }
+    else if(loop > SCHEDULE_LOOPS && !schedule.repair)
+    {
+        schedule.decision = SCHEDULE_CONTINUE;     /* repairs are chosen within schedule_available(). */
+    }
+    else if(task_left > left)
+    {
+        schedule.decision = SCHEDULE_STOP;
+    }
+    else if(schedule.loop_elapsed <= schedule.loop_budget)
+    {
+        schedule.decision = SCHEDULE_CONTINUE;
+    }
+    else
+    {
+        /* over budget: a board nearly done is cheaper than a new one, granted twice its estimate once
+         * (a loop stuck short of the board does not eat the budget of the others). */
+        if(schedule.grace < 0.0)
+        {
+            schedule.grace = task_left < schedule.loop_estimate ? 2.0 * task_left : 0.0;
+        }
+        if(schedule.loop_elapsed <= schedule.loop_budget + schedule.grace)
+        {
+            schedule.decision = SCHEDULE_CONTINUE;
+        }
+        else
+        {
+            /* repair is checked again when failures are fixed. */
+            schedule.decision = left >= after ? SCHEDULE_DEFER : SCHEDULE_SKIP;
+        }
+    }
+    return schedule.decision;
+}
+
+void schedule_repair(MissionSchedule& schedule, double budget, const ros::Time& now)
+{
+    schedule.repair = true;
+    schedule.loop_start = now;
+    schedule.loop_elapsed = 0.0;
+    schedule.loop_budget = budget;
+    schedule.grace = -1.0;
+}
+
+void schedule_loop_ended(MissionSchedule& schedule, ScheduleDecision decision)
+{
+    schedule.decision = decision;
+    if(decision == SCHEDULE_DEFER)
+    {
+        schedule.deferred++;
+    }
+    else if(decision == SCHEDULE_SKIP)
+    {
+        schedule.skipped++;
+    }
+}
+
+const char* schedule_decision_name(ScheduleDecision decision)
+{
+    switch(decision)
+    {
+    case SCHEDULE_CONTINUE:     return "continue";
+    case SCHEDULE_DEFER:        return "defer";
+    case SCHEDULE_SKIP:         return "skip";
+    case SCHEDULE_STOP:         return "stop";
+    case SCHEDULE_RETURN_HOME:  return "return home";
+    }
+    return "unknown";
+}
+
+void schedule_telemetry(const MissionSchedule& schedule, const ros::Time& now, state_machine::MissionBudget& msg)
+{
+    msg.header.stamp = now;
+    msg.loop = schedule.loop;
+    msg.elapsed = schedule.elapsed;
+    msg.remaining = schedule.remaining;
+    msg.loop_elapsed = schedule.loop_elapsed;
+    msg.loop_budget = schedule.loop_budget;
+    msg.loop_estimate = schedule.loop_estimate;
+    msg.task_left = schedule.task_left;
+    msg.home_cost = schedule.home_cost;
+    msg.slack = schedule.slack;
+    msg.decision = schedule.decision;
+    msg.finished = schedule.finished;
+    msg.deferred = schedule.deferred;
+    msg.skipped = schedule.skipped;
+}
@@ -13,6 +13,7 @@
 #include <state_machine/State.h>
 #include <state_machine/CommandTOL.h>
 #include <state_machine/Setpoint.h>
+#include <state_machine/PositionTarget.h>
 #include <state_machine/DrawingBoard10.h>
 
 /* subscribe messages from pixhawk. -libn */
@@ -26,141 +27,46 @@
 #include <state_machine/VISION_NUM_SCAN_M2P.h>
 #include <state_machine/VISION_ONE_NUM_GET_M2P.h>
 #include <state_machine/YAW_SP_CALCULATED_M2P.h>
-
-/* on ros info msg */
-//#define NO_ROS_DEBUG
-
-/* select ROS rate */
-#ifdef NO_ROS_DEBUG
-#define ROS_RATE 20.0
-#else
-#define ROS_RATE 10.0
-#endif
-
-
-#define SPRAY_DISTANCE 2.2  /* distance from UAV to drawing board while sparying. */
-#define VISION_SCAN_DISTANCE 2.7  /* distance from UAV to drawing board while hoveing and scanning. */
-
-#define SAFE_HEIGHT_DISTANCE 0.42  /* distanche from drawing board's height to expected height: 0: real mission; >0: for safe. */
-#define FIXED_POS_HEIGHT 1.4    /* height of point: O */
-#define TAKEOFF_HEIGHT 1.8  /* height of point H. */
-
-#define SCAN_HEIGHT 1.6 /* constant height while scanning. */ //height of point: L, R
-#define SCAN_MOVE_SPEED 2 /* error bewteen pos* and pos. */
-#define SCAN_VISION_DISTANCE 4
-bool scan_to_get_pos = false;
+#include <state_machine/MissionBudget.h>
+#include <state_machine/DigitVote.h>
+#include <state_machine/BoardMapDelta.h>
+
+#include <state_machine/mission.h>
+#include <state_machine/board_mirror.h>
+#include <state_machine/setpoint_streamer.h>
+#include <state_machine/mission_clock.h>
+#include <state_machine/vehicle_state.h>
+#include <state_machine/seqlock.h>
+#include <state_machine/command_executor.h>
+#include <state_machine/offboard_bootstrap.h>
+#include <ros/callback_queue.h>
 
 #include <math.h>
 
 #include <std_msgs/Int32.h>
 
-#define MAX_FLIGHT_TIME 240 /* max flight time of whole mission. */
-
-#include <state_machine/FailureRecord.h>
-#define FAILURE_REPAIR 1    /* FAILURE_REPAIR: 0: never repair errores; 1: repair errors. */
-
-void state_machine_func(void);
-/* mission state. -libn */
-static const int takeoff = 1;
-static const int mission_hover_after_takeoff = 2;
-static const int mission_hover_only = 3;
-static const int mission_observe_point_go = 5;
-static const int mission_observe_num_wait = 6;
-static const int mission_num_search = 8;
-static const int mission_num_scan_again = 9;
-static const int mission_num_locate = 10;
-static const int mission_num_get_close = 11;
-static const int mission_arm_spread = 12;
-static const int mission_num_hover_spray = 13;
-static const int mission_num_done = 14;
-static const int mission_return_home = 15;
-static const int land = 16;
-static const int mission_end = 17;
-static const int mission_hover_before_spary = 18;
-static const int mission_fix_failure = 19;
-static const int mission_hover_after_stretch_back = 20;
-static const int mission_force_return_home = 21;
-
-/* state added for scanning mission. */
-static const int mission_scan_left_go = 31;
-static const int mission_scan_right_move = 32;
-static const int mission_scan_right_hover = 33;
-static const int mission_scan_left_move = 34;
-static const int mission_scan_left_hover = 35;
-static const int mission_scan_left2_hover = 36;
-
-int loop = 0;	/* loop calculator: loop = 0/1/2/3/4/5. -libn */
-// current mission state, initial state is to takeoff
-int current_mission_state = takeoff;
-ros::Time mission_last_time;	/* timer used in mission. -libn */
-bool display_screen_num_recognized = false;	/* to check if the num on display screen is recognized. -libn */
-bool relocate_valid = false;	/* to complete relocate mission. -libn */
-
-int current_mission_num;	/* mission num: 5 subtask -> 5 current nums.	TODO:change mission num. -libn */
-int last_mission_num;
-
-bool velocity_control_enable = true;
-
-ros::Time mission_timer_start_time;	/* timer to control the whole mission and 5 subtasks. -libn */
-bool mission_timer_enable = true;   /* start mission_timer. */
-bool force_home_enable = true;
-bool loop_timer_disable = false;
-
-/* 4 setpoints. -libn */
-geometry_msgs::PoseStamped setpoint_A;
-geometry_msgs::PoseStamped setpoint_L;
-geometry_msgs::PoseStamped setpoint_R;
-geometry_msgs::PoseStamped setpoint_D;
-geometry_msgs::PoseStamped setpoint_H;	/* home position. -libn */
-
-state_machine::FailureRecord failure[5];
-int mission_failure_acount = 0;
-
-state_machine::State current_state;
-state_machine::State last_state;
-state_machine::State last_state_display;
-void state_cb(const state_machine::State::ConstPtr& msg){
-	last_state_display.mode = current_state.mode;
-	last_state_display.armed = current_state.armed;
-	current_state = *msg;
-}
+MissionContext mission;    /* mission state, only used by the control loop(main thread). */
+OffbMissionEngine mission_state_machine = mission_engine(takeoff);  /* current mission state, initial state is to takeoff */
 
-state_machine::YAW_SP_CALCULATED_M2P yaw_sp_calculated_m2p_data,yaw_sp_pub2GCS;
-geometry_msgs::PoseStamped pose_pub;
-geometry_msgs::TwistStamped vel_pub;	/* velocity setpoint to be published. -libn */
+/* pose, velocity, state and vision callbacks run on their own queues(AsyncSpinner threads) and only
+ * write the latest value into a snapshot, the control loop reads them in snapshot_update(). */
+Seqlock<VehicleState> state_snapshot;
+Seqlock<PoseSnapshot> pos_snapshot;
+Seqlock<VelocitySnapshot> vel_snapshot;
+Seqlock<BoardSnapshots> board_snapshot;
+Seqlock<NumSnapshot> vision_num_snapshot;
 
-
-/* calculate distance */
-double circle_distance(double x1, double x2, double y1, double y2, double z1, double z2)
-{
-    return sqrt((x2-x1)*(x2-x1)+(y2-y1)*(y2-y1)+(z2-z1)*(z2-z1));
+VehicleState current_state;    /* mode interned on arrival, no string copy per message. */
+VehicleState last_state;
+VehicleState last_state_display;
+void state_cb(const state_machine::State::ConstPtr& msg){
+    VehicleState state;
+    vehicle_state_update(state, *msg);
+    state_snapshot.write(state);
 }
 
-/* limit angle_rad to [-pi,pi]. */
-float wrap_pi(float angle_rad)
-{
-    /* value is inf or NaN */
-    if (angle_rad > 10 || angle_rad < -10) {
-        return angle_rad;
-    }
-    int c = 0;
-    while (angle_rad >= M_PI) {
-        angle_rad -= M_PI*2;
-
-        if (c++ > 3) {
-            return NAN;
-        }
-    }
-    c = 0;
-    while (angle_rad < -M_PI) {
-        angle_rad += M_PI*2;
+state_machine::YAW_SP_CALCULATED_M2P yaw_sp_calculated_m2p_data,yaw_sp_pub2GCS;
 
-        if (c++ > 3) {
-            return NAN;
-        }
-    }
-    return angle_rad;
-}
 
 ros::Publisher  yaw_sp_calculated_m2p_pub;
 
@@ -174,24 +80,24 @@ void SetpointIndexedCallback(const state_machine::Setpoint::ConstPtr& msg)
     switch(setpoint_indexed.index)
     {
         case 1:
-            setpoint_A.pose.position.x = setpoint_indexed.x;
-            setpoint_A.pose.position.y = setpoint_indexed.y;
-//            setpoint_A.pose.position.z = setpoint_indexed.z;
+            mission.setpoint_A.pose.position.x = setpoint_indexed.x;
+            mission.setpoint_A.pose.position.y = setpoint_indexed.y;
+//            mission.setpoint_A.pose.position.z = setpoint_indexed.z;
             break;
         case 2:
-            setpoint_L.pose.position.x = setpoint_indexed.x;
-            setpoint_L.pose.position.y = setpoint_indexed.y;
-//            setpoint_L.pose.position.z = setpoint_indexed.z;
+            mission.setpoint_L.pose.position.x = setpoint_indexed.x;
+            mission.setpoint_L.pose.position.y = setpoint_indexed.y;
+//            mission.setpoint_L.pose.position.z = setpoint_indexed.z;
             break;
         case 3:
-            setpoint_R.pose.position.x = setpoint_indexed.x;
-            setpoint_R.pose.position.y = setpoint_indexed.y;
-//            setpoint_R.pose.position.z = setpoint_indexed.z;
+            mission.setpoint_R.pose.position.x = setpoint_indexed.x;
+            mission.setpoint_R.pose.position.y = setpoint_indexed.y;
+//            mission.setpoint_R.pose.position.z = setpoint_indexed.z;
             break;
         case 4:
-            setpoint_D.pose.position.x = setpoint_indexed.x;    /* not used! */
-            setpoint_D.pose.position.y = setpoint_indexed.y;
-//            setpoint_D.pose.position.z = setpoint_indexed.z;
+            mission.setpoint_D.pose.position.x = setpoint_indexed.x;    /* not used! */
+            mission.setpoint_D.pose.position.y = setpoint_indexed.y;
+//            mission.setpoint_D.pose.position.z = setpoint_indexed.z;
             break;
         default:
             #ifdef NO_ROS_DEBUG
@@ -201,18 +107,19 @@ void SetpointIndexedCallback(const state_machine::Setpoint::ConstPtr& msg)
     }
 
     /* calculate yaw*. -libn */
-    deta_x = setpoint_R.pose.position.x - setpoint_L.pose.position.x;
-    deta_y = setpoint_R.pose.position.y - setpoint_L.pose.position.y;
+    deta_x = mission.setpoint_R.pose.position.x - mission.setpoint_L.pose.position.x;
+    deta_y = mission.setpoint_R.pose.position.y - mission.setpoint_L.pose.position.y;
     yaw_sp_calculated_m2p_data.yaw_sp = atan2(deta_y,deta_x);
     yaw_sp_calculated_m2p_data.yaw_sp = wrap_pi(yaw_sp_calculated_m2p_data.yaw_sp + M_PI/2);    /* yaw* in ENU in rad within [-pi,pi]. */
+    mission.yaw_sp = yaw_sp_calculated_m2p_data.yaw_sp;
     #ifdef NO_ROS_DEBUG
     ROS_INFO("yaw*(ENU) calculated for test with send4setpoint running.");
     #endif
     /* yaw* for controller. */
-    pose_pub.pose.orientation.x = 0;			/* orientation expressed using quaternion. -libn */
-    pose_pub.pose.orientation.y = 0;			/* w = cos(theta/2), x = nx * sin(theta/2),  y = ny * sin(theta/2), z = nz * sin(theta/2) -libn */
-    pose_pub.pose.orientation.z = sin(yaw_sp_calculated_m2p_data.yaw_sp/2);
-    pose_pub.pose.orientation.w = cos(yaw_sp_calculated_m2p_data.yaw_sp/2);		/* set yaw* = 90 degree(default in simulation). -libn */
+    mission.pose_pub.pose.orientation.x = 0;			/* orientation expressed using quaternion. -libn */
+    mission.pose_pub.pose.orientation.y = 0;			/* w = cos(theta/2), x = nx * sin(theta/2),  y = ny * sin(theta/2), z = nz * sin(theta/2) -libn */
+    mission.pose_pub.pose.orientation.z = sin(yaw_sp_calculated_m2p_data.yaw_sp/2);
+    mission.pose_pub.pose.orientation.w = cos(yaw_sp_calculated_m2p_data.yaw_sp/2);		/* set yaw* = 90 degree(default in simulation). -libn */
 
     /* publish yaw_sp to pixhawk. */
     yaw_sp_calculated_m2p_pub.publish(yaw_sp_calculated_m2p_data);
@@ -224,30 +131,28 @@ void SetpointIndexedCallback(const state_machine::Setpoint::ConstPtr& msg)
 }
 
 // local position msg callback function
-geometry_msgs::PoseStamped current_pos;
 void pos_cb(const geometry_msgs::PoseStamped::ConstPtr& msg)
 {
-    current_pos = *msg;
+    PoseSnapshot pos;
+    pose_snapshot(pos, *msg);
+    pos_snapshot.write(pos);
 }
 
 // local velocity msg callback function
-geometry_msgs::TwistStamped current_vel;
 void vel_cb(const geometry_msgs::TwistStamped::ConstPtr& msg)
 {
-    current_vel = *msg;
-//    ROS_INFO("Vx = %f Vy = %f Vz = %f",current_vel.twist.linear.x,current_vel.twist.linear.y,current_vel.twist.linear.z);
+    VelocitySnapshot vel;
+    velocity_snapshot(vel, *msg);
+    vel_snapshot.write(vel);
+//    ROS_INFO("Vx = %f Vy = %f Vz = %f",mission.current_vel.linear.x,mission.current_vel.linear.y,mission.current_vel.linear.z);
 }
 
 /* 10 drawing board positions. -libn */
-state_machine::DrawingBoard10 board10;
 void board_pos_cb(const state_machine::DrawingBoard10::ConstPtr& msg)
 {
-    /* stop update while in operation. */
-    if(current_mission_state != mission_arm_spread &&
-            current_mission_state != mission_num_hover_spray)
-    {
-        board10 = *msg;
-    }
+    BoardSnapshots boards;
+    boards_snapshot(boards, *msg);
+    board_snapshot.write(boards);
 
 //	ROS_INFO("\nboard_0 position: %d x = %f y = %f z = %f\n"
 //				"board_1 position: %d x = %f y = %f z = %f\n"
@@ -259,29 +164,36 @@ void board_pos_cb(const state_machine::DrawingBoard10::ConstPtr& msg)
 //				"board_7 position: %d x = %f y = %f z = %f\n"
 //				"board_8 position: %d x = %f y = %f z = %f\n"
 //				"board_9 position: %d x = %f y = %f z = %f\n",
-//				board10.drawingboard[0].valid,board10.drawingboard[0].x,board10.drawingboard[0].y,board10.drawingboard[0].z,
-//				board10.drawingboard[1].valid,board10.drawingboard[1].x,board10.drawingboard[1].y,board10.drawingboard[1].z,
-//				board10.drawingboard[2].valid,board10.drawingboard[2].x,board10.drawingboard[2].y,board10.drawingboard[2].z,
-//				board10.drawingboard[3].valid,board10.drawingboard[3].x,board10.drawingboard[3].y,board10.drawingboard[3].z,
-//				board10.drawingboard[4].valid,board10.drawingboard[4].x,board10.drawingboard[4].y,board10.drawingboard[4].z,
-//				board10.drawingboard[5].valid,board10.drawingboard[5].x,board10.drawingboard[5].y,board10.drawingboard[5].z,
-//				board10.drawingboard[6].valid,board10.drawingboard[6].x,board10.drawingboard[6].y,board10.drawingboard[6].z,
-//				board10.drawingboard[7].valid,board10.drawingboard[7].x,board10.drawingboard[7].y,board10.drawingboard[7].z,
-//				board10.drawingboard[8].valid,board10.drawingboard[8].x,board10.drawingboard[8].y,board10.drawingboard[8].z,
-//				board10.drawingboard[9].valid,board10.drawingboard[9].x,board10.drawingboard[9].y,board10.drawingboard[9].z);
+//				mission.board[0].valid,mission.board[0].x,mission.board[0].y,mission.board[0].z,
+//				mission.board[1].valid,mission.board[1].x,mission.board[1].y,mission.board[1].z,
+//				mission.board[2].valid,mission.board[2].x,mission.board[2].y,mission.board[2].z,
+//				mission.board[3].valid,mission.board[3].x,mission.board[3].y,mission.board[3].z,
+//				mission.board[4].valid,mission.board[4].x,mission.board[4].y,mission.board[4].z,
+//				mission.board[5].valid,mission.board[5].x,mission.board[5].y,mission.board[5].z,
+//				mission.board[6].valid,mission.board[6].x,mission.board[6].y,mission.board[6].z,
+//				mission.board[7].valid,mission.board[7].x,mission.board[7].y,mission.board[7].z,
+//				mission.board[8].valid,mission.board[8].x,mission.board[8].y,mission.board[8].z,
+//				mission.board[9].valid,mission.board[9].x,mission.board[9].y,mission.board[9].z);
 }
 
-
-ros::Publisher  fixed_target_return_m2p_pub;
-
-/* transform to ENU from NED. */
-void position_x_ENU_from_NED(float x_NED, float y_NED, float z_NED, float* pos_ENU_f)
+/* board map deltas: only boards changed are applied, nothing is written while the map is stable. */
+BoardMirror board_mirror;   /* vision callback queue only. */
+void board_delta_cb(const state_machine::BoardMapDelta::ConstPtr& msg)
 {
-    *pos_ENU_f = y_NED;
-    *(pos_ENU_f+1) = x_NED;
-    *(pos_ENU_f+2) = -z_NED;
+    unsigned lost = board_mirror.lost;
+    if(board_mirror_apply(board_mirror, *msg))
+    {
+        board_snapshot.write(board_mirror.boards);
+    }
+    if(board_mirror.lost != lost)
+    {
+        ROS_WARN("board map: %u delta(s) lost, boards resent by the next keyframe", board_mirror.lost - lost);
+    }
 }
 
+
+ros::Publisher  fixed_target_return_m2p_pub;
+
 /* limit the error between (x2,y2) and (x1,y1). */
 void error_limit(double x1, double y1, double x2, double y2, double* result)
 {
@@ -303,80 +215,21 @@ void fixed_target_position_p2m_cb(const state_machine::FIXED_TARGET_POSITION_P2M
             fixed_target_position_p2m_data.home_z);
     #endif
 
-	/* publish messages to pixhawk. -libn */
-    fixed_target_return_m2p_data.home_x = fixed_target_position_p2m_data.home_x;
-    fixed_target_return_m2p_data.home_y = fixed_target_position_p2m_data.home_y;
-    fixed_target_return_m2p_data.home_z = -TAKEOFF_HEIGHT;
-
-    fixed_target_return_m2p_data.observe_x = fixed_target_position_p2m_data.observe_x;
-    fixed_target_return_m2p_data.observe_y = fixed_target_position_p2m_data.observe_y;
-    fixed_target_return_m2p_data.observe_z = -FIXED_POS_HEIGHT;
-
-    fixed_target_return_m2p_data.spray_left_x = fixed_target_position_p2m_data.spray_left_x;
-    fixed_target_return_m2p_data.spray_left_y = fixed_target_position_p2m_data.spray_left_y;
-    fixed_target_return_m2p_data.spray_left_z = -SCAN_HEIGHT;
+    /* get 4 fixed_setpoint and yaw*. */
+    mission_fixed_targets(mission, fixed_target_position_p2m_data, fixed_target_return_m2p_data);
 
-    fixed_target_return_m2p_data.spray_right_x = fixed_target_position_p2m_data.spray_right_x;
-    fixed_target_return_m2p_data.spray_right_y = fixed_target_position_p2m_data.spray_right_y;
-    fixed_target_return_m2p_data.spray_right_z = -SCAN_HEIGHT;
+	/* publish messages to pixhawk. -libn */
     fixed_target_return_m2p_pub.publish(fixed_target_return_m2p_data);
     #ifdef NO_ROS_DEBUG	
     ROS_INFO("publishing fixed_target_return_m2p(NED): %f\t%f\t%f\t",
             fixed_target_return_m2p_data.home_x,
             fixed_target_return_m2p_data.home_y,
             fixed_target_return_m2p_data.home_z);
-    #endif
-
-    /* get 4 fixed_setpoint. */
-    /* transform position from NED to ENU. */
-    float pos_ENU[3] = {0,0,0};
-    position_x_ENU_from_NED(fixed_target_position_p2m_data.home_x,
-                            fixed_target_position_p2m_data.home_y,
-                            fixed_target_position_p2m_data.home_z,
-                            pos_ENU);
-    setpoint_H.pose.position.x = pos_ENU[0];
-    setpoint_H.pose.position.y = pos_ENU[1];
-//    setpoint_H.pose.position.z = pos_ENU[2];
-
-    position_x_ENU_from_NED(fixed_target_position_p2m_data.observe_x,
-                            fixed_target_position_p2m_data.observe_y,
-                            fixed_target_position_p2m_data.observe_z,
-                            pos_ENU);
-    setpoint_A.pose.position.x = pos_ENU[0];
-    setpoint_A.pose.position.y = pos_ENU[1];
-//    setpoint_A.pose.position.z = pos_ENU[2];
-
-    position_x_ENU_from_NED(fixed_target_position_p2m_data.spray_left_x,
-                            fixed_target_position_p2m_data.spray_left_y,
-                            fixed_target_position_p2m_data.spray_left_z,
-                            pos_ENU);
-    setpoint_L.pose.position.x = pos_ENU[0];
-    setpoint_L.pose.position.y = pos_ENU[1];
-//    setpoint_L.pose.position.z = pos_ENU[2];
-
-    position_x_ENU_from_NED(fixed_target_position_p2m_data.spray_right_x,
-                            fixed_target_position_p2m_data.spray_right_y,
-                            fixed_target_position_p2m_data.spray_right_z,
-                            pos_ENU);
-    setpoint_R.pose.position.x = pos_ENU[0];
-    setpoint_R.pose.position.y = pos_ENU[1];
-//    setpoint_R.pose.position.z = pos_ENU[2];
-
-    /* calculate yaw*. -libn */
-    deta_x = setpoint_R.pose.position.x - setpoint_L.pose.position.x;
-    deta_y = setpoint_R.pose.position.y - setpoint_L.pose.position.y;
-    yaw_sp_calculated_m2p_data.yaw_sp = atan2(deta_y,deta_x);
-    yaw_sp_calculated_m2p_data.yaw_sp = wrap_pi(yaw_sp_calculated_m2p_data.yaw_sp + M_PI/2);    /* yaw* in NED in rad within [-pi,pi]. */
-    #ifdef NO_ROS_DEBUG
     ROS_INFO("yaw*(ENU) calculated using fixed_position from GCS.");
     #endif
-    /* yaw* for controller. */
-    pose_pub.pose.orientation.x = 0;			/* orientation expressed using quaternion. -libn */
-    pose_pub.pose.orientation.y = 0;			/* w = cos(theta/2), x = nx * sin(theta/2),  y = ny * sin(theta/2), z = nz * sin(theta/2) -libn */
-    pose_pub.pose.orientation.z = sin(yaw_sp_calculated_m2p_data.yaw_sp/2);
-    pose_pub.pose.orientation.w = cos(yaw_sp_calculated_m2p_data.yaw_sp/2);		/* set yaw* = 90 degree(default in simulation). -libn */
 
     /* publish yaw_sp to pixhawk. */
+    yaw_sp_calculated_m2p_data.yaw_sp = mission.yaw_sp;
     yaw_sp_pub2GCS.yaw_sp = wrap_pi(-(yaw_sp_calculated_m2p_data.yaw_sp - M_PI/2));
     yaw_sp_calculated_m2p_pub.publish(yaw_sp_pub2GCS);
     #ifdef NO_ROS_DEBUG
@@ -401,19 +254,185 @@ void task_status_change_p2m_cb(const state_machine::TASK_STATUS_CHANGE_P2M::Cons
 				task_status_change_p2m_data.loop_value);
     #endif
     task_status_monitor_m2p_data.spray_duration = task_status_change_p2m_data.spray_duration;
+    /* spray time per board from GCS(same queue as the mission loop). */
+    if(task_status_change_p2m_data.spray_duration > 0.0f)
+    {
+        mission.spray_config.duration = task_status_change_p2m_data.spray_duration;
+    }
 }
 
 std_msgs::Int32 vision_num_data;
 void vision_num_cb(const std_msgs::Int32::ConstPtr& msg){
     vision_num_data = *msg;
-    current_mission_num = vision_num_data.data;
+    NumSnapshot snapshot;
+    snapshot.num = vision_num_data.data;
+    snapshot.confidence = 0.0f;     /* not known: hover before leaving. */
+    vision_num_snapshot.write(snapshot);
     #ifdef NO_ROS_DEBUG
     ROS_INFO("subscribing vision_num_data = %d", vision_num_data.data);
     #endif
 }
 
+/* num voted by get_board_position, certain already. */
+void vision_num_vote_cb(const state_machine::DigitVote::ConstPtr& msg){
+    NumSnapshot snapshot;
+    snapshot.num = msg->num;
+    snapshot.confidence = msg->confidence;
+    vision_num_snapshot.write(snapshot);
+    #ifdef NO_ROS_DEBUG
+    ROS_INFO("subscribing vision_num_vote = %d(%.3f, %d of %d)", msg->num, msg->confidence, msg->votes, msg->window);
+    #endif
+}
+
 std_msgs::Int32 camera_switch_data;
 ros::Publisher  camera_switch_pub;
+/* publish camera_switch changed by mission. */
+void camera_switch_update(void)
+{
+    if(mission.camera_switch_pending)
+    {
+        camera_switch_data.data = mission.camera_switch;
+        camera_switch_pub.publish(camera_switch_data);
+        mission.camera_switch_pending = false;
+    }
+}
+
+/* payload valve: published when the spray controller changed it. */
+ros::Publisher actuator_control_pub;
+void actuator_control_update(void)
+{
+    if(mission.spray.output_pending)
+    {
+        actuator_control_pub.publish(mission.spray.output);
+        mission.spray.output_pending = false;
+    }
+}
+
+/* setpoints: published at SETPOINT_RATE, between mission targets given at ROS_RATE. */
+ros::Publisher local_pos_pub;
+ros::Publisher local_vel_pub;
+ros::Publisher local_raw_pub;
+bool setpoint_raw_enable = true;    /* PositionTarget with feed-forward instead of pose/velocity setpoints. */
+SetpointStreamer setpoint_streamer(trajectory_default_limits(1.0/ROS_RATE));
+geometry_msgs::PoseStamped pose_stream;     /* reused for every position setpoint. */
+state_machine::PositionTarget raw_stream;   /* reused for every PositionTarget. */
+void setpoint_publish(void)
+{
+    ros::Time now = ros::Time::now();
+    if(mission.velocity_control_enable)
+    {
+        /* start position control from here, at the speed measured. */
+        setpoint_streamer.reset(mission.current_pos.position, mission.current_vel.linear, now);
+        if(setpoint_raw_enable)
+        {
+            velocity_target(now, mission.vel_pub.twist.linear, quaternion_yaw(mission.pose_pub.pose.orientation), raw_stream);
+            local_raw_pub.publish(raw_stream);
+        }
+        else
+        {
+            local_vel_pub.publish(mission.vel_pub);
+        }
+    }
+    else if(setpoint_raw_enable)
+    {
+        setpoint_streamer.position_target(now, quaternion_yaw(mission.pose_pub.pose.orientation), raw_stream);
+        local_raw_pub.publish(raw_stream);
+    }
+    else
+    {
+        pose_stream.header.stamp = now;
+        pose_stream.pose.orientation = mission.pose_pub.pose.orientation;
+        pose_stream.pose.position = setpoint_streamer.sample(now);
+        local_pos_pub.publish(pose_stream);
+    }
+}
+
+/* new mission target: limit it and stream towards it. */
+void setpoint_update(void)
+{
+    if(!mission.velocity_control_enable)    /* position control. */
+    {
+        /* limit error(x,y) between current position and destination within [-1,1]. */
+        if(fabs(mission.pose_pub.pose.position.x - mission.current_pos.position.x) > 30 ||
+            fabs(mission.pose_pub.pose.position.y - mission.current_pos.position.y) > 30)
+        {
+            double error_temp[2] = {0,0};
+            error_limit(mission.current_pos.position.x,mission.current_pos.position.y,mission.pose_pub.pose.position.x,mission.pose_pub.pose.position.y,error_temp);
+            mission.pose_pub.pose.position.x = mission.current_pos.position.x + 30*error_temp[0];
+            mission.pose_pub.pose.position.y = mission.current_pos.position.y + 30*error_temp[1];
+        }
+        setpoint_streamer.set_target(mission.pose_pub.pose.position, ros::Time::now());
+    }
+}
+
+/* event-driven mode: arrival checks run as soon as a new pose arrives, not at next tick(ROS_RATE).
+ * tick still runs timers and all other checks. */
+bool event_driven_enable = true;
+RosClock mission_clock;  /* mission time source, replaced by ManualClock in mission_harness. */
+void mission_react(void)
+{
+    if(!event_driven_enable || current_state.mode != MODE_OFFBOARD || !current_state.armed)
+    {
+        return;
+    }
+    mission.now = mission_clock.now();
+    if(mission_state_machine.react(mission, MISSION_EVENT_POSE))
+    {
+        setpoint_update();
+        camera_switch_update();
+        actuator_control_update();
+    }
+}
+
+/* latest values from the callback threads -> mission context. read once per stream cycle
+ * (SETPOINT_RATE): a new pose or velocity is seen within one cycle. */
+unsigned state_seq = 0, pos_seq = 0, vel_seq = 0, board_seq = 0, vision_num_seq = 0;
+uint32_t board_epoch = 0;   /* of the boards copied into the mission. */
+void snapshot_update(void)
+{
+    if(state_snapshot.sequence() != state_seq)
+    {
+        VehicleState state;
+        state_seq = state_snapshot.read(state);
+        last_state_display.mode = current_state.mode;
+        last_state_display.armed = current_state.armed;
+        current_state = state;
+    }
+
+    if(vision_num_snapshot.sequence() != vision_num_seq)
+    {
+        NumSnapshot vision_num;
+        vision_num_seq = vision_num_snapshot.read(vision_num);
+        mission.current_mission_num = vision_num.num;
+        mission.num_confidence = vision_num.confidence;
+    }
+
+    /* stop update while in operation. */
+    if(board_snapshot.sequence() != board_seq &&
+            mission_state_machine.state() != mission_arm_spread &&
+            mission_state_machine.state() != mission_num_hover_spray)
+    {
+        BoardSnapshots boards;
+        board_seq = board_snapshot.read(boards);
+        board_mirror_copy(boards, mission.board, board_epoch);  /* boards changed since the last copy. */
+    }
+
+    bool moved = false;
+    if(pos_snapshot.sequence() != pos_seq)
+    {
+        pos_seq = pos_snapshot.read(mission.current_pos);
+        moved = true;
+    }
+    if(vel_snapshot.sequence() != vel_seq)
+    {
+        vel_seq = vel_snapshot.read(mission.current_vel);
+        moved = true;
+    }
+    if(moved)
+    {
+        mission_react();
+    }
+}
 
 //void vision_one_num_get_cal(void)
 //{
@@ -430,16 +449,47 @@ int main(int argc, char **argv)
 {
     ros::init(argc, argv, "offb_node");
     ros::NodeHandle nh;
-
-    ros::Subscriber state_sub = nh.subscribe<state_machine::State>
+    ros::NodeHandle nh_private("~");
+    nh_private.param("event_driven", event_driven_enable, true);
+
+    /* minimum-jerk trajectory to each mission target, trajectory_max_velocity <= 0: step targets. */
+    TrajectoryLimits trajectory_limits = trajectory_default_limits(1.0/ROS_RATE);
+    nh_private.param("trajectory_max_velocity", trajectory_limits.max_velocity, trajectory_limits.max_velocity);
+    nh_private.param("trajectory_max_acceleration", trajectory_limits.max_acceleration, trajectory_limits.max_acceleration);
+    setpoint_streamer = SetpointStreamer(trajectory_limits);
+    nh_private.param("setpoint_raw", setpoint_raw_enable, true);
+
+    /* auto_offboard: request OFFBOARD and arming(simulation), otherwise the pilot switches and arms. */
+    BootstrapConfig bootstrap_config = bootstrap_default_config();
+    bool auto_offboard = false;
+    nh_private.param("auto_offboard", auto_offboard, false);
+    nh_private.param("bootstrap_stream_time", bootstrap_config.min_stream_time, bootstrap_config.min_stream_time);
+    bootstrap_config.request_offboard = auto_offboard;
+    bootstrap_config.request_arm = auto_offboard;
+    OffboardBootstrap bootstrap(bootstrap_config, ros::Time::now());
+
+    /* pose, velocity, state and vision are serviced on their own queues by AsyncSpinner threads:
+     * a slow callback or a burst of board messages delays neither the others nor the control loop. */
+    ros::CallbackQueue pos_queue, vel_queue, state_queue, vision_queue;
+    ros::NodeHandle nh_pos, nh_vel, nh_state, nh_vision;
+    nh_pos.setCallbackQueue(&pos_queue);
+    nh_vel.setCallbackQueue(&vel_queue);
+    nh_state.setCallbackQueue(&state_queue);
+    nh_vision.setCallbackQueue(&vision_queue);
+
+    ros::Subscriber state_sub = nh_state.subscribe<state_machine::State>
             ("mavros/state", 10, state_cb);
-    ros::Publisher local_pos_pub = nh.advertise<geometry_msgs::PoseStamped>
+    local_pos_pub = nh.advertise<geometry_msgs::PoseStamped>
             ("mavros/setpoint_position/local", 10);
 
     /* Velocity setpoint. -libn */
-    ros::Publisher local_vel_pub = nh.advertise<geometry_msgs::TwistStamped>
+    local_vel_pub = nh.advertise<geometry_msgs::TwistStamped>
                 ("/mavros/setpoint_velocity/cmd_vel", 10);
 
+    /* position, velocity and acceleration together: PX4 tracks the trajectory without lag. */
+    local_raw_pub = nh.advertise<state_machine::PositionTarget>
+                ("mavros/setpoint_raw/local", 10);
+
     ros::ServiceClient arming_client = nh.serviceClient<state_machine::CommandBool>
             ("mavros/cmd/arming");
     ros::ServiceClient set_mode_client = nh.serviceClient<state_machine::SetMode>
@@ -451,17 +501,35 @@ int main(int argc, char **argv)
     state_machine::CommandTOL landing_cmd;
     landing_cmd.request.min_pitch = 1.0;
 
+    /* service calls run on the executor thread: a slow mavros answer does not stop setpoint streaming. */
+    CommandExecutor command_executor;
+    CommandOptions land_options = command_default_options();
+    std::future<CommandResult> land_result;
+    /* single attempt: the bootstrap retries on the next vehicle state. */
+    CommandOptions bootstrap_options = command_default_options();
+    bootstrap_options.max_attempts = 1;
+    bootstrap_options.timeout = 1.0;
+    std::future<CommandResult> bootstrap_result;
+    state_machine::SetMode offb_set_mode;
+    offb_set_mode.request.custom_mode = flight_mode_name(MODE_OFFBOARD);
+    state_machine::CommandBool arm_cmd;
+    arm_cmd.request.value = true;
+
 	/* receive indexed setpoint. -libn */
 	ros::Subscriber setpoint_Indexed_sub = nh.subscribe("Setpoint_Indexed", 100 ,SetpointIndexedCallback);
 	/* get pixhawk's local position. -libn */
-	ros::Subscriber local_pos_sub = nh.subscribe<geometry_msgs::PoseStamped>("mavros/local_position/pose", 10, pos_cb);
+	ros::Subscriber local_pos_sub = nh_pos.subscribe<geometry_msgs::PoseStamped>("mavros/local_position/pose", 10, pos_cb);
 
     /* get pixhawk's local velocity. -libn */
-    ros::Subscriber local_vel_sub = nh.subscribe<geometry_msgs::TwistStamped>("mavros/local_position/velocity", 10, vel_cb);
+    ros::Subscriber local_vel_sub = nh_vel.subscribe<geometry_msgs::TwistStamped>("mavros/local_position/velocity", 10, vel_cb);
 
-	ros::Subscriber DrawingBoard_Position_sub = nh.subscribe<state_machine::DrawingBoard10>
-		            ("DrawingBoard_Position10", 10, board_pos_cb);
-	board10.drawingboard.resize(10);		/* MUST! -libn */
+    /* board positions: deltas(default), or the whole board map after every change. */
+    bool board_delta_enable;
+    nh_private.param("board_delta", board_delta_enable, true);
+    board_mirror_reset(board_mirror);
+	ros::Subscriber DrawingBoard_Position_sub = board_delta_enable ?
+            nh_vision.subscribe<state_machine::BoardMapDelta>("board_map_delta", 10, board_delta_cb) :
+            nh_vision.subscribe<state_machine::DrawingBoard10>("DrawingBoard_Position10", 10, board_pos_cb);
 
 	/* subscribe messages from pixhawk. -libn */
     ros::Subscriber fixed_target_position_p2m_sub = nh.subscribe<state_machine::FIXED_TARGET_POSITION_P2M>("mavros/fixed_target_position_p2m", 10, fixed_target_position_p2m_cb);
@@ -477,40 +545,56 @@ int main(int argc, char **argv)
 
     camera_switch_pub  = nh.advertise<std_msgs::Int32>("camera_switch", 10);
 
-    /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-    camera_switch_data.data = 0;
-
-    /* get vision_num */
-    ros::Subscriber vision_num_sub = nh.subscribe<std_msgs::Int32>("vision_num", 10, vision_num_cb);
+    /* spray valve(payload group). */
+    actuator_control_pub = nh.advertise<state_machine::ActuatorControl>("mavros/actuator_control", 10);
 
-    //the setpoint publishing rate MUST be faster than 2Hz
-    ros::Rate rate(10.0);
-
-    // wait for FCU connection
-    while(ros::ok() && !current_state.connected){
-        ros::spinOnce();
-        rate.sleep();
-    }
+    /* scheduler budget state, once per mission tick. */
+    ros::Publisher mission_budget_pub = nh.advertise<state_machine::MissionBudget>("mission_budget", 10);
+    state_machine::MissionBudget mission_budget;
 
+    /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
+    camera_switch_data.data = 0;
 
-    if(1)   /* initialisation: send 100 setpoints. */
+    /* get vision_num: voted num with its confidence, or the plain num(1s hover before leaving). */
+    bool num_vote_enable;
+    nh_private.param("num_vote", num_vote_enable, true);
+    ros::Subscriber vision_num_sub = num_vote_enable ?
+            nh_vision.subscribe<state_machine::DigitVote>("vision_num_vote", 10, vision_num_vote_cb) :
+            nh_vision.subscribe<std_msgs::Int32>("vision_num", 10, vision_num_cb);
+
+    ros::AsyncSpinner pos_spinner(1, &pos_queue);
+    ros::AsyncSpinner vel_spinner(1, &vel_queue);
+    ros::AsyncSpinner state_spinner(1, &state_queue);
+    ros::AsyncSpinner vision_spinner(1, &vision_queue);
+    pos_spinner.start();
+    vel_spinner.start();
+    state_spinner.start();
+    vision_spinner.start();
+
+    /* mission runs at ROS_RATE, setpoints are streamed at SETPOINT_RATE. */
+    ros::Rate stream_rate(SETPOINT_RATE);
+
+    /* initialisation: stream setpoints until FCU connected and PX4 will accept OFFBOARD. */
+    if(1)
     {
         /* local velocity setpoint publish. -libn */
-        vel_pub.twist.linear.x = 0.0f;
-        vel_pub.twist.linear.y = 0.0f;
-        vel_pub.twist.linear.z = 2.0f;
-        vel_pub.twist.angular.x = 0.0f;
-        vel_pub.twist.angular.y = 0.0f;
-        vel_pub.twist.angular.z = 0.0f;
+        mission.vel_pub.twist.linear.x = 0.0f;
+        mission.vel_pub.twist.linear.y = 0.0f;
+        mission.vel_pub.twist.linear.z = 2.0f;
+        mission.vel_pub.twist.angular.x = 0.0f;
+        mission.vel_pub.twist.angular.y = 0.0f;
+        mission.vel_pub.twist.angular.z = 0.0f;
 //        #ifdef NO_ROS_DEBUG
-        ROS_INFO("sending 100 setpoints, please wait 10 seconds!");
+        ROS_INFO("streaming setpoints, waiting for FCU!");
 //        #endif
-        //send a few setpoints before starting
-        for(int i = 100; ros::ok() && i > 0; --i){
-//            local_pos_pub.publish(pose_pub);
-            local_vel_pub.publish(vel_pub);
+        while(ros::ok() && !bootstrap.stream_ready())
+        {
+//            local_pos_pub.publish(mission.pose_pub);
+            local_vel_pub.publish(mission.vel_pub);
             ros::spinOnce();
-            rate.sleep();
+            snapshot_update();
+            bootstrap.update(current_state, ros::Time::now(), false);
+            stream_rate.sleep();
         }
     }
     ROS_INFO("Initialization finished!");
@@ -522,7 +606,7 @@ int main(int argc, char **argv)
     last_state.mode = current_state.mode;
     last_state.armed = current_state.armed;
     #ifdef NO_ROS_DEBUG
-    ROS_INFO("current_state.mode = %s",current_state.mode.c_str());
+    ROS_INFO("current_state.mode = %s",flight_mode_name(current_state.mode));
     ROS_INFO("armed status: %d",current_state.armed);
     #endif
 
@@ -531,27 +615,14 @@ int main(int argc, char **argv)
      * current_mission_num, camera_switch_data. */
     if(1)
     {
-        setpoint_H.pose.position.x = current_pos.pose.position.x;
-        setpoint_H.pose.position.y = current_pos.pose.position.y;
-        setpoint_H.pose.position.z = TAKEOFF_HEIGHT;  /* it's better to choose z* = SAFE_HEIGHT_DISTANCE(no altitude lost). */
-
-        setpoint_A.pose.position.x = 0.0f;
-        setpoint_A.pose.position.y = 0.0f;
-        setpoint_A.pose.position.z = FIXED_POS_HEIGHT;
-
-        setpoint_L.pose.position.x = 0.0f;
-        setpoint_L.pose.position.y = 0.0f;
-        setpoint_L.pose.position.z = SCAN_HEIGHT;
-
-        setpoint_R.pose.position.x = 0.0f;
-        setpoint_R.pose.position.y = 0.0f;
-        setpoint_R.pose.position.z = SCAN_HEIGHT;
-
-        setpoint_D.pose.position.x = 0.0f;
-        setpoint_D.pose.position.y = 0.0f;
-        setpoint_D.pose.position.z = FIXED_POS_HEIGHT;
-
-        yaw_sp_calculated_m2p_data.yaw_sp = 90*M_PI/180;   /* default yaw*(90 degree)(ENU) -> North! */
+        mission_init(mission);
+        nh_private.param("spray_duration", mission.spray_config.duration, mission.spray_config.duration);
+        nh_private.param("scan_continuous", mission.scan_continuous, mission.scan_continuous);   /* false: stop-and-hover scan. */
+        nh_private.param("scan_sweep_speed", mission.scan_sweep_speed, mission.scan_sweep_speed);
+        camera_switch_update();
+        actuator_control_update();  /* valve closed. */
+
+        yaw_sp_calculated_m2p_data.yaw_sp = mission.yaw_sp;   /* default yaw*(90 degree)(ENU) -> North! */
         /* publish yaw_sp to pixhawk. */
         yaw_sp_calculated_m2p_pub.publish(yaw_sp_calculated_m2p_data);
         #ifdef NO_ROS_DEBUG
@@ -560,51 +631,61 @@ int main(int argc, char **argv)
         #endif
 
         /* yaw* for controller. */
-        pose_pub.pose.orientation.x = 0;			/* orientation expressed using quaternion. -libn */
-        pose_pub.pose.orientation.y = 0;			/* w = cos(theta/2), x = nx * sin(theta/2),  y = ny * sin(theta/2), z = nz * sin(theta/2) -libn */
-        pose_pub.pose.orientation.z = sin(yaw_sp_calculated_m2p_data.yaw_sp/2);
-        pose_pub.pose.orientation.w = cos(yaw_sp_calculated_m2p_data.yaw_sp/2);
-
-        for(int co = 0; co<10; ++co)
-        {
-            /* set param valid true as default to make state machine able to run, and I am sure all numbers will be valid!(vision) */
-            board10.drawingboard[co].valid = false;  /* Normly it should be false as the default setting. */
-            board10.drawingboard[co].x = 0.0f;
-            board10.drawingboard[co].y = 0.0f;
-            board10.drawingboard[co].z = 0.0f;  /* it's safe for we have SAFE_HEIGHT_DISTANCE. */
-        }
-        current_mission_num = 0;    /* set current_mission_num as 0 as default. */
-        last_mission_num = 0;
-
-        /* camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-        camera_switch_data.data = 0;    /* vision used for vision_num_scan as default. */
-        camera_switch_pub.publish(camera_switch_data);
-//        ROS_INFO("send camera_switch_data = %d",(int)camera_switch_data.data);
+        mission.pose_pub.pose.orientation.x = 0;			/* orientation expressed using quaternion. -libn */
+        mission.pose_pub.pose.orientation.y = 0;			/* w = cos(theta/2), x = nx * sin(theta/2),  y = ny * sin(theta/2), z = nz * sin(theta/2) -libn */
+        mission.pose_pub.pose.orientation.z = sin(yaw_sp_calculated_m2p_data.yaw_sp/2);
+        mission.pose_pub.pose.orientation.w = cos(yaw_sp_calculated_m2p_data.yaw_sp/2);
 
         /* default spray_duration */
         task_status_monitor_m2p_data.spray_duration = 1.0f;
 
-        /* failure recorded. */
-        failure[0].num = -1; failure[0].state = takeoff;
-        failure[1].num = -1; failure[1].state = takeoff;
-        failure[2].num = -1; failure[2].state = takeoff;
-        failure[3].num = -1; failure[3].state = takeoff;
-        failure[4].num = -1; failure[4].state = takeoff;
-
     }
 
     int send_vision_num_count = 0;  /* used to publish vision_scanning results. */
 
+    const int stream_per_mission = (int)(SETPOINT_RATE/ROS_RATE + 0.5);
+    int stream_count = 0;
+
+    bool bootstrap_done = false;
+
     while(ros::ok())
     {
+        snapshot_update();
 
-        /* camera switch for test(set in state_machine_func for mission) and mode switch display(Once when freshed). -libn */
+        /* OFFBOARD and arming requested as soon as PX4 accepts them. */
+        BootstrapRequest request = bootstrap.update(current_state, ros::Time::now(), command_pending(bootstrap_result));
+        if(request == BOOTSTRAP_SET_OFFBOARD)
+        {
+            bootstrap_result = command_executor.submit("mavros/set_mode", set_mode_client, offb_set_mode, bootstrap_options);
+        }
+        else if(request == BOOTSTRAP_ARM)
+        {
+            bootstrap_result = command_executor.submit("mavros/cmd/arming", arming_client, arm_cmd, bootstrap_options);
+        }
+        if(bootstrap.done() && !bootstrap_done)
+        {
+            bootstrap.report();
+        }
+        bootstrap_done = bootstrap.done();
+
+        if(++stream_count < stream_per_mission)
+        {
+            mission_spray_stream(mission, mission_clock.now());
+            actuator_control_update();
+            setpoint_publish();
+            ros::spinOnce();
+            stream_rate.sleep();
+            continue;
+        }
+        stream_count = 0;
+
+        /* camera switch for test(set in mission for mission) and mode switch display(Once when freshed). -libn */
         if(1)
         {
 
-            if(current_state.mode == "MANUAL" && last_state.mode != "MANUAL")
+            if(current_state.mode == MODE_MANUAL && last_state.mode != MODE_MANUAL)
             {
-                last_state.mode = "MANUAL";
+                last_state.mode = MODE_MANUAL;
                 #ifdef NO_ROS_DEBUG
                 ROS_INFO("switch to mode: MANUAL");
                 #endif
@@ -619,9 +700,9 @@ int main(int argc, char **argv)
 //                current_mission_state = 12;
 
             }
-            if(current_state.mode == "ALTCTL" && last_state.mode != "ALTCTL")
+            if(current_state.mode == MODE_ALTCTL && last_state.mode != MODE_ALTCTL)
             {
-                last_state.mode = "ALTCTL";
+                last_state.mode = MODE_ALTCTL;
                 #ifdef NO_ROS_DEBUG
                 ROS_INFO("switch to mode: ALTCTL");
                 #endif
@@ -636,9 +717,9 @@ int main(int argc, char **argv)
 //                current_mission_state = 13;
 
             }
-            if(current_state.mode == "OFFBOARD" && last_state.mode != "OFFBOARD")
+            if(current_state.mode == MODE_OFFBOARD && last_state.mode != MODE_OFFBOARD)
             {
-                last_state.mode = "OFFBOARD";
+                last_state.mode = MODE_OFFBOARD;
                 #ifdef NO_ROS_DEBUG
                 ROS_INFO("switch to mode: OFFBOARD");
                 #endif
@@ -656,107 +737,87 @@ int main(int argc, char **argv)
             }
 
         }
-        if(current_state.mode == "MANUAL" && current_state.armed)
+        if(current_state.mode == MODE_MANUAL && current_state.armed)
         {
             camera_switch_data.data = 0;    /* disable camere. */
             camera_switch_pub.publish(camera_switch_data);
             #ifdef NO_ROS_DEBUG
             ROS_INFO("send camera_switch_data = %d",(int)camera_switch_data.data);
             #endif
-            current_mission_num = -1;    /* set current_mission_num as 0 as default. */
-            last_mission_num = -1;   /* disable the initial mission_num gotten before takeoff. */
+            mission.current_mission_num = -1;    /* set mission.current_mission_num as 0 as default. */
+            mission.last_mission_num = -1;   /* disable the initial mission_num gotten before takeoff. */
 
         }
 
         // landing
-		if(current_state.armed && current_mission_state == land)	/* set landing mode until uav stops. -libn */
+		if(current_state.armed && mission_state_machine.state() == land)	/* set landing mode until uav stops. -libn */
 		{
-            if(current_state.mode != "MANUAL" &&
-               current_state.mode != "AUTO.LAND" &&
+            if(current_state.mode != MODE_MANUAL &&
+               current_state.mode != MODE_AUTO_LAND &&
+               !command_pending(land_result) &&
                (ros::Time::now() - last_request > ros::Duration(5.0)))
 			{
-				if(land_client.call(landing_cmd) && landing_cmd.response.success)
-				{
-//                    #ifdef NO_ROS_DEBUG
-					ROS_INFO("AUTO LANDING!");
-//                    #endif
-				}
+				land_result = command_executor.submit("mavros/cmd/land", land_client, landing_cmd, land_options);
 				last_request = ros::Time::now();
 			}
 		}
+		if(command_ready(land_result))
+		{
+			CommandResult result = land_result.get();
+			if(result.status == COMMAND_SUCCESS)
+			{
+//                #ifdef NO_ROS_DEBUG
+				ROS_INFO("AUTO LANDING!");
+//                #endif
+			}
+			else
+			{
+				ROS_WARN("land command %s after %d attempts", command_status_name(result.status), result.attempts);
+			}
+		}
 
         /* state_machine start and mission state display. -libn */
-		if(current_state.mode == "OFFBOARD" && current_state.armed)	/* set message display delay(0.5s). -libn */
+		if(current_state.mode == MODE_OFFBOARD && current_state.armed)	/* set message display delay(0.5s). -libn */
 		{
             #ifdef NO_ROS_DEBUG
 			ROS_INFO("now I am in OFFBOARD and armed mode!");	/* state machine! -libn */
             #endif
 
-			state_machine_func();
+            mission.now = mission_clock.now();
+			mission_state_machine.tick(mission);
+            camera_switch_update();
 
-            /* system timer. TODO! */
-            if(1)
-            {
-                /* set time deadline. */
-                /* mission timer(5 loops). -libn */
-                if(ros::Time::now() - mission_timer_start_time > ros::Duration(MAX_FLIGHT_TIME + mission_failure_acount * 30.0f)
-                        && force_home_enable == true)
-                {
-                    force_home_enable = false; /* force once! */
-                    current_mission_state = mission_force_return_home;	/* mission timeout. -libn */
-                    #ifdef NO_ROS_DEBUG
-                    ROS_INFO("mission time out! -> return to home!");
-                    #endif
-                    mission_last_time = ros::Time::now();   /* start counting time(for hovering). */
-                }
-                /* subtask timer(1 loop). -libn */
-                if(!loop_timer_disable)
-                {
-                    if(ros::Time::now() - mission_timer_start_time > ros::Duration((float)(loop*30.0f+50.0f)) &&
-                       ros::Time::now() - mission_timer_start_time < ros::Duration(MAX_FLIGHT_TIME + mission_failure_acount * 30.0f) &&
-                            loop <= 5)  /* stop subtask timer when dealing with failures. */
-                    {
-                        /* error recorded! */
-                        mission_failure_acount++;
-                        failure[mission_failure_acount-1].num = current_mission_num;
-                        failure[mission_failure_acount-1].state = current_mission_state;
-                        loop++;
-                        #ifdef NO_ROS_DEBUG
-                        ROS_INFO("loop timeout -> start next loop");
-                        #endif
-                        current_mission_state = mission_observe_point_go;	/* loop timeout, forced to switch to next loop. -libn */
-                        /* TODO: mission failure recorded(using switch/case). -libn */
-
-                    }
-                }
-
-            }
+            /* system timer. */
+            mission_timers(mission, mission_state_machine);
+            actuator_control_update();
+            schedule_telemetry(mission.schedule, mission.now, mission_budget);
+            mission_budget_pub.publish(mission_budget);
 
             if(1)   /* ROS_INFO display. */
             {
                 #ifdef NO_ROS_DEBUG
-                ROS_INFO("current loop: %d",loop);
-                ROS_INFO("current_mission_state: %d",current_mission_state);
+                ROS_INFO("current loop: %d",mission.loop);
+                ROS_INFO("current_mission_state: %d",mission_state_machine.state());
                 #endif
-                if(velocity_control_enable)
+                if(mission.velocity_control_enable)
                 {
                     #ifdef NO_ROS_DEBUG
-                    ROS_INFO("velocity*: %5.3f %5.3f %5.3f",vel_pub.twist.linear.x, vel_pub.twist.linear.y, vel_pub.twist.linear.z);
+                    ROS_INFO("velocity*: %5.3f %5.3f %5.3f",mission.vel_pub.twist.linear.x, mission.vel_pub.twist.linear.y, mission.vel_pub.twist.linear.z);
                     #endif
                 }
                 else
                 {
                     #ifdef NO_ROS_DEBUG
-                    ROS_INFO("position*: %5.3f %5.3f %5.3f",pose_pub.pose.position.x,pose_pub.pose.position.y,pose_pub.pose.position.z);
+                    ROS_INFO("position*: %5.3f %5.3f %5.3f",mission.pose_pub.pose.position.x,mission.pose_pub.pose.position.y,mission.pose_pub.pose.position.z);
                     #endif
                 }
                 #ifdef NO_ROS_DEBUG
-                ROS_INFO("current position: %5.3f %5.3f %5.3f\n",current_pos.pose.position.x,current_pos.pose.position.y,current_pos.pose.position.z);
+                ROS_INFO("current position: %5.3f %5.3f %5.3f\n",mission.current_pos.position.x,mission.current_pos.position.y,mission.current_pos.position.z);
 
-                ROS_INFO("current_mission_num = %d",current_mission_num);
-                ROS_INFO("board: current_mission_num: %d\n"
-                        "position:%5.3f %5.3f %5.3f",current_mission_num,board10.drawingboard[current_mission_num].x,
-                        board10.drawingboard[current_mission_num].y,board10.drawingboard[current_mission_num].z);
+                ROS_INFO("mission.current_mission_num = %d",mission.current_mission_num);
+                ROS_INFO("board: mission.current_mission_num: %d\n"
+                        "position:%5.3f %5.3f %5.3f",mission.current_mission_num,mission.board[mission.current_mission_num].x,
+                        mission.board[mission.current_mission_num].y,mission.board[mission.current_mission_num].z);
                 ROS_INFO("spray time = %f",(float)task_status_change_p2m_data.spray_duration);
                 #endif
 
@@ -773,16 +834,16 @@ int main(int argc, char **argv)
     //					"board7: %d %5.3f %5.3f %5.3f \n"
     //					"board8: %d %5.3f %5.3f %5.3f \n"
     //					"board9: %d %5.3f %5.3f %5.3f \n",
-    //					board10.drawingboard[0].valid,board10.drawingboard[0].x,board10.drawingboard[0].y,board10.drawingboard[0].z,
-    //					board10.drawingboard[1].valid,board10.drawingboard[1].x,board10.drawingboard[1].y,board10.drawingboard[1].z,
-    //					board10.drawingboard[2].valid,board10.drawingboard[2].x,board10.drawingboard[2].y,board10.drawingboard[2].z,
-    //					board10.drawingboard[3].valid,board10.drawingboard[3].x,board10.drawingboard[3].y,board10.drawingboard[3].z,
-    //					board10.drawingboard[4].valid,board10.drawingboard[4].x,board10.drawingboard[4].y,board10.drawingboard[4].z,
-    //					board10.drawingboard[5].valid,board10.drawingboard[5].x,board10.drawingboard[5].y,board10.drawingboard[5].z,
-    //					board10.drawingboard[6].valid,board10.drawingboard[6].x,board10.drawingboard[6].y,board10.drawingboard[6].z,
-    //					board10.drawingboard[7].valid,board10.drawingboard[7].x,board10.drawingboard[7].y,board10.drawingboard[7].z,
-    //					board10.drawingboard[8].valid,board10.drawingboard[8].x,board10.drawingboard[8].y,board10.drawingboard[8].z,
-    //					board10.drawingboard[9].valid,board10.drawingboard[9].x,board10.drawingboard[9].y,board10.drawingboard[9].z);
+    //					mission.board[0].valid,mission.board[0].x,mission.board[0].y,mission.board[0].z,
+    //					mission.board[1].valid,mission.board[1].x,mission.board[1].y,mission.board[1].z,
+    //					mission.board[2].valid,mission.board[2].x,mission.board[2].y,mission.board[2].z,
+    //					mission.board[3].valid,mission.board[3].x,mission.board[3].y,mission.board[3].z,
+    //					mission.board[4].valid,mission.board[4].x,mission.board[4].y,mission.board[4].z,
+    //					mission.board[5].valid,mission.board[5].x,mission.board[5].y,mission.board[5].z,
+    //					mission.board[6].valid,mission.board[6].x,mission.board[6].y,mission.board[6].z,
+    //					mission.board[7].valid,mission.board[7].x,mission.board[7].y,mission.board[7].z,
+    //					mission.board[8].valid,mission.board[8].x,mission.board[8].y,mission.board[8].z,
+    //					mission.board[9].valid,mission.board[9].x,mission.board[9].y,mission.board[9].z);
 
             }
 
@@ -792,26 +853,26 @@ int main(int argc, char **argv)
 			if(current_state.mode != last_state_display.mode || last_state_display.armed != current_state.armed)
 			{
                 #ifdef NO_ROS_DEBUG
-				ROS_INFO("current_state.mode = %s",current_state.mode.c_str());
-				ROS_INFO("last_state_display.mode = %s",last_state_display.mode.c_str());
+				ROS_INFO("current_state.mode = %s",flight_mode_name(current_state.mode));
+				ROS_INFO("last_state_display.mode = %s",flight_mode_name(last_state_display.mode));
 				ROS_INFO("armed status: %d\n",current_state.armed);
                 #endif
 				last_state_display.armed = current_state.armed;
 				last_state_display.mode = current_state.mode;
                 #ifdef NO_ROS_DEBUG
-				ROS_INFO("current position: %5.3f %5.3f %5.3f", current_pos.pose.position.x, 	  	current_pos.pose.position.y, current_pos.pose.position.z);
+				ROS_INFO("current position: %5.3f %5.3f %5.3f", mission.current_pos.position.x, 	  	mission.current_pos.position.y, mission.current_pos.position.z);
 
 				ROS_INFO("setpoint_received:\n"
-                        "setpoint_A(ENU):%5.3f %5.3f %5.3f \n"
-                        "setpoint_L(ENU):%5.3f %5.3f %5.3f \n"
-                        "setpoint_R(ENU):%5.3f %5.3f %5.3f \n"
-                        "setpoint_D(ENU):%5.3f %5.3f %5.3f \n"
-                        "setpoint_H(ENU):%5.3f %5.3f %5.3f",
-						setpoint_A.pose.position.x,setpoint_A.pose.position.y,setpoint_A.pose.position.z,
-                        setpoint_L.pose.position.x,setpoint_L.pose.position.y,setpoint_L.pose.position.z,
-                        setpoint_R.pose.position.x,setpoint_R.pose.position.y,setpoint_R.pose.position.z,
-						setpoint_D.pose.position.x,setpoint_D.pose.position.y,setpoint_D.pose.position.z,
-                        setpoint_H.pose.position.x,setpoint_H.pose.position.y,setpoint_H.pose.position.z);
+                        "mission.setpoint_A(ENU):%5.3f %5.3f %5.3f \n"
+                        "mission.setpoint_L(ENU):%5.3f %5.3f %5.3f \n"
+                        "mission.setpoint_R(ENU):%5.3f %5.3f %5.3f \n"
+                        "mission.setpoint_D(ENU):%5.3f %5.3f %5.3f \n"
+                        "mission.setpoint_H(ENU):%5.3f %5.3f %5.3f",
+						mission.setpoint_A.pose.position.x,mission.setpoint_A.pose.position.y,mission.setpoint_A.pose.position.z,
+                        mission.setpoint_L.pose.position.x,mission.setpoint_L.pose.position.y,mission.setpoint_L.pose.position.z,
+                        mission.setpoint_R.pose.position.x,mission.setpoint_R.pose.position.y,mission.setpoint_R.pose.position.z,
+						mission.setpoint_D.pose.position.x,mission.setpoint_D.pose.position.y,mission.setpoint_D.pose.position.z,
+                        mission.setpoint_H.pose.position.x,mission.setpoint_H.pose.position.y,mission.setpoint_H.pose.position.z);
                 ROS_INFO("yaw_sp(ENU) = rad:%f deg:%f",yaw_sp_calculated_m2p_data.yaw_sp,yaw_sp_calculated_m2p_data.yaw_sp*180/M_PI);
                 ROS_INFO("board_position_received(ENU):\n"
 						"board0: %d %5.3f %5.3f %5.3f \n"
@@ -824,20 +885,20 @@ int main(int argc, char **argv)
 						"board7: %d %5.3f %5.3f %5.3f \n"
 						"board8: %d %5.3f %5.3f %5.3f \n"
 						"board9: %d %5.3f %5.3f %5.3f \n",
-						board10.drawingboard[0].valid,board10.drawingboard[0].x,board10.drawingboard[0].y,board10.drawingboard[0].z,
-						board10.drawingboard[1].valid,board10.drawingboard[1].x,board10.drawingboard[1].y,board10.drawingboard[1].z,
-						board10.drawingboard[2].valid,board10.drawingboard[2].x,board10.drawingboard[2].y,board10.drawingboard[2].z,
-						board10.drawingboard[3].valid,board10.drawingboard[3].x,board10.drawingboard[3].y,board10.drawingboard[3].z,
-						board10.drawingboard[4].valid,board10.drawingboard[4].x,board10.drawingboard[4].y,board10.drawingboard[4].z,
-						board10.drawingboard[5].valid,board10.drawingboard[5].x,board10.drawingboard[5].y,board10.drawingboard[5].z,
-						board10.drawingboard[6].valid,board10.drawingboard[6].x,board10.drawingboard[6].y,board10.drawingboard[6].z,
-						board10.drawingboard[7].valid,board10.drawingboard[7].x,board10.drawingboard[7].y,board10.drawingboard[7].z,
-						board10.drawingboard[8].valid,board10.drawingboard[8].x,board10.drawingboard[8].y,board10.drawingboard[8].z,
-						board10.drawingboard[9].valid,board10.drawingboard[9].x,board10.drawingboard[9].y,board10.drawingboard[9].z);
-                ROS_INFO("current_mission_num = %d",current_mission_num);
-                ROS_INFO("board: current_mission_num: %d\n"
-                        "position:%5.3f %5.3f %5.3f",current_mission_num,board10.drawingboard[current_mission_num].x,
-                        board10.drawingboard[current_mission_num].y,board10.drawingboard[current_mission_num].z);
+						mission.board[0].valid,mission.board[0].x,mission.board[0].y,mission.board[0].z,
+						mission.board[1].valid,mission.board[1].x,mission.board[1].y,mission.board[1].z,
+						mission.board[2].valid,mission.board[2].x,mission.board[2].y,mission.board[2].z,
+						mission.board[3].valid,mission.board[3].x,mission.board[3].y,mission.board[3].z,
+						mission.board[4].valid,mission.board[4].x,mission.board[4].y,mission.board[4].z,
+						mission.board[5].valid,mission.board[5].x,mission.board[5].y,mission.board[5].z,
+						mission.board[6].valid,mission.board[6].x,mission.board[6].y,mission.board[6].z,
+						mission.board[7].valid,mission.board[7].x,mission.board[7].y,mission.board[7].z,
+						mission.board[8].valid,mission.board[8].x,mission.board[8].y,mission.board[8].z,
+						mission.board[9].valid,mission.board[9].x,mission.board[9].y,mission.board[9].z);
+                ROS_INFO("mission.current_mission_num = %d",mission.current_mission_num);
+                ROS_INFO("board: mission.current_mission_num: %d\n"
+                        "position:%5.3f %5.3f %5.3f",mission.current_mission_num,mission.board[mission.current_mission_num].x,
+                        mission.board[mission.current_mission_num].y,mission.board[mission.current_mission_num].z);
 //                ROS_INFO("SCREEN_HEIGHT = %d SAFE_HEIGHT_DISTANCE = %d",(int)SCREEN_HEIGHT,(int)SAFE_HEIGHT_DISTANCE);
                 ROS_INFO("SAFE_HEIGHT_DISTANCE = %d",(int)SAFE_HEIGHT_DISTANCE);
                 #endif
@@ -845,18 +906,7 @@ int main(int argc, char **argv)
 			}
 		}
 
-        if(!velocity_control_enable)    /* position control. */
-        {
-            /* limit error(x,y) between current position and destination within [-1,1]. */
-            if(abs(pose_pub.pose.position.x - current_pos.pose.position.x) > 30 ||
-                abs(pose_pub.pose.position.y - current_pos.pose.position.y) > 30)
-            {
-                double error_temp[2] = {0,0};
-                error_limit(current_pos.pose.position.x,current_pos.pose.position.y,pose_pub.pose.position.x,pose_pub.pose.position.y,error_temp);
-                pose_pub.pose.position.x = current_pos.pose.position.x + 30*error_temp[0];
-                pose_pub.pose.position.y = current_pos.pose.position.y + 30*error_temp[1];
-            }
-        }
+        setpoint_update();
 
         if(1)   /* publish messages to pixhawk. */
         {
@@ -873,19 +923,19 @@ int main(int argc, char **argv)
 //    //				obstacle_position_m2p_data.obstacle_valid);
 
 //            task_status_monitor_m2p_data.spray_duration = 0.3f;
-            task_status_monitor_m2p_data.task_status = current_mission_state;
-            task_status_monitor_m2p_data.loop_value = loop;
-            if(velocity_control_enable)
+            task_status_monitor_m2p_data.task_status = mission_state_machine.state();
+            task_status_monitor_m2p_data.loop_value = mission.loop;
+            if(mission.velocity_control_enable)
             {
-                task_status_monitor_m2p_data.target_x = current_pos.pose.position.y;
-                task_status_monitor_m2p_data.target_y = current_pos.pose.position.x;
-                task_status_monitor_m2p_data.target_z = -current_pos.pose.position.z;
+                task_status_monitor_m2p_data.target_x = mission.current_pos.position.y;
+                task_status_monitor_m2p_data.target_y = mission.current_pos.position.x;
+                task_status_monitor_m2p_data.target_z = -mission.current_pos.position.z;
             }
             else
             {
-                task_status_monitor_m2p_data.target_x = pose_pub.pose.position.y;
-                task_status_monitor_m2p_data.target_y = pose_pub.pose.position.x;
-                task_status_monitor_m2p_data.target_z = -pose_pub.pose.position.z;
+                task_status_monitor_m2p_data.target_x = mission.pose_pub.pose.position.y;
+                task_status_monitor_m2p_data.target_y = mission.pose_pub.pose.position.x;
+                task_status_monitor_m2p_data.target_z = -mission.pose_pub.pose.position.z;
             }
             task_status_monitor_m2p_pub.publish(task_status_monitor_m2p_data);
     //		ROS_INFO("publishing task_status_monitor_m2p: %f %d %d %f %f %f",
@@ -901,10 +951,10 @@ int main(int argc, char **argv)
             send_vision_num_count++;
             send_vision_num_count = send_vision_num_count % 10;
             vision_num_scan_m2p_data.board_num = send_vision_num_count;
-            vision_num_scan_m2p_data.board_x = board10.drawingboard[send_vision_num_count].y,
-            vision_num_scan_m2p_data.board_y = board10.drawingboard[send_vision_num_count].x,
-            vision_num_scan_m2p_data.board_z = -board10.drawingboard[send_vision_num_count].z,
-            vision_num_scan_m2p_data.board_valid = board10.drawingboard[send_vision_num_count].valid;
+            vision_num_scan_m2p_data.board_x = mission.board[send_vision_num_count].y,
+            vision_num_scan_m2p_data.board_y = mission.board[send_vision_num_count].x,
+            vision_num_scan_m2p_data.board_z = -mission.board[send_vision_num_count].z,
+            vision_num_scan_m2p_data.board_valid = mission.board[send_vision_num_count].valid;
 
             vision_num_scan_m2p_pub.publish(vision_num_scan_m2p_data);
 //            }
@@ -917,8 +967,8 @@ int main(int argc, char **argv)
     //				vision_num_scan_m2p_data.board_z,
     //				vision_num_scan_m2p_data.board_valid);
 
-            vision_one_num_get_m2p_data.loop_value = loop;
-            vision_one_num_get_m2p_data.num = current_mission_num;
+            vision_one_num_get_m2p_data.loop_value = mission.loop;
+            vision_one_num_get_m2p_data.num = mission.current_mission_num;
             vision_one_num_get_m2p_pub.publish(vision_one_num_get_m2p_data);
     //		ROS_INFO("publishing vision_one_num_get_m2p: %d %d",
     //				vision_one_num_get_m2p_data.loop_value,
@@ -927,611 +977,12 @@ int main(int argc, char **argv)
         }
 
 
-        if(velocity_control_enable)
-        {
-        	local_vel_pub.publish(vel_pub);
-        }
-        else
-        {
-        	local_pos_pub.publish(pose_pub);
-        }
+        setpoint_publish();
 
         ros::spinOnce();
-        rate.sleep();
+        stream_rate.sleep();
     }
 
+    command_executor.report();
     return 0;
 }
-
-/* task state machine. -libn */
-void state_machine_func(void)
-{
-	switch(current_mission_state)
-	{
-		case takeoff:
-            /* start mission_timer once. */
-            if(mission_timer_enable)
-            {
-                mission_timer_start_time = ros::Time::now();    /* start mission_timer. */
-                mission_timer_enable = false;
-            }
-			/* local velocity setpoint publish. -libn */
-            velocity_control_enable = true;
-            vel_pub.twist.linear.x = 0.0f;
-			vel_pub.twist.linear.y = 0.0f;
-            vel_pub.twist.linear.z = 2.2f;
-			vel_pub.twist.angular.x = 0.0f;
-			vel_pub.twist.angular.y = 0.0f;
-			vel_pub.twist.angular.z = 0.0f;
-            if(current_vel.twist.linear.z > 0.5 &&
-               current_pos.pose.position.z > 0.8)
-            {
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("current_vel.twist.linear.x = %f",current_vel.twist.linear.x);
-                #endif
-
-                current_mission_state = mission_hover_after_takeoff; // current_mission_state++;
-                mission_last_time = ros::Time::now();
-
-                velocity_control_enable = false;
-                pose_pub.pose.position.x = current_pos.pose.position.x;
-                pose_pub.pose.position.y = current_pos.pose.position.y;
-                pose_pub.pose.position.z = setpoint_H.pose.position.z;
-
-                /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-                camera_switch_data.data = 0;
-                camera_switch_pub.publish(camera_switch_data);
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("send camera_switch_data = %d",(int)camera_switch_data.data);
-                #endif
-
-            }
-    		break;
-
-        case mission_hover_after_takeoff:
-        	pose_pub.pose.position.x = current_pos.pose.position.x;
-        	pose_pub.pose.position.y = current_pos.pose.position.y;
-        	pose_pub.pose.position.z = setpoint_H.pose.position.z;
-            if(ros::Time::now() - mission_last_time > ros::Duration(3))	/* hover for 5 seconds. -libn */
-        	{
-//                current_mission_state = mission_observe_point_go; // current_mission_state++;
-                current_mission_state = mission_scan_left_go; // current_mission_state++;
-        	}
-            break;
-
-        /* add scan mission  --start. */
-        case mission_scan_left_go:
-            pose_pub.pose.position.x = setpoint_L.pose.position.x - SCAN_VISION_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.y = setpoint_L.pose.position.y - SCAN_VISION_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = SCAN_HEIGHT;
-//            if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 0.2) &&      // switch to next state
-//               (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 0.2) &&
-//               (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 0.2))
-            if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                               current_pos.pose.position.y,pose_pub.pose.position.y,
-                               current_pos.pose.position.z,pose_pub.pose.position.z) < 0.2)
-            {
-                current_mission_state = mission_scan_right_move; // current_mission_state++;
-                mission_last_time = ros::Time::now();
-
-                /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-                camera_switch_data.data = 2;
-                camera_switch_pub.publish(camera_switch_data);
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("send camera_switch_data = %d",(int)camera_switch_data.data);
-                #endif
-
-             }
-            break;
-        case mission_scan_right_move:
-            pose_pub.pose.position.x = setpoint_R.pose.position.x - SCAN_VISION_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.y = setpoint_R.pose.position.y - SCAN_VISION_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = SCAN_HEIGHT;
-
-//            /* limit error(x,y) between current position and destination. */
-//            if(abs(pose_pub.pose.position.x - current_pos.pose.position.x) > SCAN_MOVE_SPEED ||
-//                abs(pose_pub.pose.position.y - current_pos.pose.position.y) > SCAN_MOVE_SPEED)
-//            {
-//                double error_temp[2] = {0,0};
-//                error_limit(current_pos.pose.position.x,current_pos.pose.position.y,pose_pub.pose.position.x,pose_pub.pose.position.y,error_temp);
-//                pose_pub.pose.position.x = current_pos.pose.position.x + SCAN_MOVE_SPEED*error_temp[0];
-//                pose_pub.pose.position.y = current_pos.pose.position.y + SCAN_MOVE_SPEED*error_temp[1];
-//            }
-
-//            if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 0.2) &&      // switch to next state
-//               (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 0.2) &&
-//               (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 0.2))
-            if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                               current_pos.pose.position.y,pose_pub.pose.position.y,
-                               current_pos.pose.position.z,pose_pub.pose.position.z) < 0.2)
-            {
-                current_mission_state = mission_scan_right_hover; // current_mission_state++;
-                mission_last_time = ros::Time::now();
-            }
-            break;
-        case mission_scan_right_hover:
-            pose_pub.pose.position.x = setpoint_R.pose.position.x - SCAN_VISION_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.y = setpoint_R.pose.position.y - SCAN_VISION_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = SCAN_HEIGHT;
-            if(ros::Time::now() - mission_last_time > ros::Duration(1))	/* hover for 5 seconds. -libn */
-            {
-                current_mission_state = mission_scan_left_move; // current_mission_state++;
-                mission_last_time = ros::Time::now();
-
-                if(scan_to_get_pos && board10.drawingboard[current_mission_num].valid)
-                {
-                    current_mission_state = mission_num_locate;
-                    scan_to_get_pos = false;
-                }
-            }
-            break;
-        case mission_scan_left_move:
-            pose_pub.pose.position.x = setpoint_L.pose.position.x - SCAN_VISION_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.y = setpoint_L.pose.position.y - SCAN_VISION_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = SCAN_HEIGHT;
-
-//            /* limit error(x,y) between current position and destination within [-1,1]. */
-//            if(abs(pose_pub.pose.position.x - current_pos.pose.position.x) > SCAN_MOVE_SPEED ||
-//                abs(pose_pub.pose.position.y - current_pos.pose.position.y) > SCAN_MOVE_SPEED)
-//            {
-//                double error_temp[2] = {0,0};
-//                error_limit(current_pos.pose.position.x,current_pos.pose.position.y,pose_pub.pose.position.x,pose_pub.pose.position.y,error_temp);
-//                pose_pub.pose.position.x = current_pos.pose.position.x + SCAN_MOVE_SPEED*error_temp[0];
-//                pose_pub.pose.position.y = current_pos.pose.position.y + SCAN_MOVE_SPEED*error_temp[1];
-//            }
-
-//            if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 0.2) &&      // switch to next state
-//               (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 0.2) &&
-//               (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 0.2))
-            if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                               current_pos.pose.position.y,pose_pub.pose.position.y,
-                               current_pos.pose.position.z,pose_pub.pose.position.z) < 0.2)
-            {
-                current_mission_state = mission_scan_left_hover; // current_mission_state++;
-                mission_last_time = ros::Time::now();
-            }
-            break;
-        case mission_scan_left_hover:
-            pose_pub.pose.position.x = setpoint_L.pose.position.x - SCAN_VISION_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.y = setpoint_L.pose.position.y - SCAN_VISION_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = SCAN_HEIGHT;
-            if(ros::Time::now() - mission_last_time > ros::Duration(1))	/* hover for 5 seconds. -libn */
-            {
-                if(scan_to_get_pos)
-                {
-                    if(board10.drawingboard[current_mission_num].valid)
-                    {
-                        current_mission_state = mission_num_search; // current_mission_state++;
-                        scan_to_get_pos = false;
-                    }
-                    else
-                    {
-                        current_mission_state = mission_scan_left_go; // current_mission_state++;
-                    }
-
-                }
-                else
-                {
-                    current_mission_state = mission_observe_point_go; // current_mission_state++;
-                    mission_last_time = ros::Time::now();
-                    loop++;
-                }
-
-
-                /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-                camera_switch_data.data = 0;
-                camera_switch_pub.publish(camera_switch_data);
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("send camera_switch_data = %d",(int)camera_switch_data.data);
-                #endif
-            }
-            break;
-
-        /* add scan mission  --stop. */
-
-
-        case mission_observe_point_go:
-        	if(loop > 5)
-			{
-                current_mission_state = mission_num_done; // current_mission_state++;
-				break;
-			}
-        	pose_pub.pose.position.x = setpoint_A.pose.position.x;
-			pose_pub.pose.position.y = setpoint_A.pose.position.y;
-            pose_pub.pose.position.z = setpoint_A.pose.position.z;
-            /* camera_switch revised. */
-            if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 1.0) &&      // switch to next state
-               (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 1.0))
-            {
-                /* camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-                camera_switch_data.data = 1;
-                camera_switch_pub.publish(camera_switch_data);
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("send camera_switch_data = %d",(int)camera_switch_data.data);
-                #endif
-            }
-//            if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 0.2) &&      // switch to next state
-//               (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 0.2) &&
-//               (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 0.2))
-            if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                               current_pos.pose.position.y,pose_pub.pose.position.y,
-                               current_pos.pose.position.z,pose_pub.pose.position.z) < 0.2)
-            {
-                current_mission_state = mission_observe_num_wait; // current_mission_state++;
-            	mission_last_time = ros::Time::now();
-            }
-            break;
-        case mission_observe_num_wait:
-            if(loop == 5 &&
-              (ros::Time::now() - mission_timer_start_time > ros::Duration(180)))
-            {
-                current_mission_state = mission_num_done;
-                break;
-            }
-        	pose_pub.pose.position.x = setpoint_A.pose.position.x;
-			pose_pub.pose.position.y = setpoint_A.pose.position.y;
-			pose_pub.pose.position.z = setpoint_A.pose.position.z;
-//			if(!display_screen_num_recognized)
-//			{
-//				/* TODO: to recognize the number. -libn */
-//				display_screen_num_recognized = true;	/* number recognized. -libn */
-//
-//
-//				if(loop == 1 && (ros::Time::now() - mission_last_time > ros::Duration(50)))	/* wait 50 seconds at most for the first time. -libn */
-//				{
-//					current_mission_state = mission_num_search; // current_mission_state++;
-//					/* TODO: failure recorded. -libn */
-//				}
-//				else
-//				{
-//					if(loop!= 1 && ros::Time::now() - mission_last_time > ros::Duration(10))	/* wait 10 seconds at most for recognition. -libn */
-//					{
-//						current_mission_state = mission_num_search; // current_mission_state++;
-//						/* TODO: failure recorded. -libn */
-//					}
-//				}
-//			}
-//			else
-//			{
-//				current_mission_state = mission_num_search; // current_mission_state++;
-//			}
-			//time delay added(just for test! --delete it directly!)
-            if(current_mission_num == last_mission_num)
-            {
-                current_mission_state = mission_observe_num_wait; // stop mission_state++, avoid repeating spraying. ;
-            }
-            else    /* valid number detected. */
-            {
-                if(ros::Time::now() - mission_last_time > ros::Duration(1))	/* hover for 1 seconds. -libn */
-                {
-                    current_mission_state = mission_num_search; // current_mission_state++;
-
-                    /* change and publish camera_switch_data for next subtask. */
-                    /*  camera_switch: 0: mission closed; 1: vision_one_num_get; 2: vision_num_scan. -libn */
-                    camera_switch_data.data = 2;
-                    camera_switch_pub.publish(camera_switch_data);
-                    #ifdef NO_ROS_DEBUG
-                    ROS_INFO("send camera_switch_data = %d",(int)camera_switch_data.data);
-                    #endif
-
-                    last_mission_num = current_mission_num;
-                }
-            }
-
-            break;
-        case mission_num_search:
-//        	ROS_INFO("board10.drawingboard[current_mission_num].valid = %d",board10.drawingboard[current_mission_num].valid);
-        	if(board10.drawingboard[current_mission_num].valid)
-        	{
-//        		ROS_INFO("Now I am making decision.\n"
-//        				"current_pos: x = %5.3f y = %5.3f z = %5.3f\n"
-//        				"board10.drawingboard[%d]_pos: x = %5.3f y = %5.3f z = %5.3f\n",
-//						current_pos.pose.position.x, current_pos.pose.position.y, current_pos.pose.position.z,
-//						current_mission_num,board10.drawingboard[current_mission_num].x,
-//						board10.drawingboard[current_mission_num].y,board10.drawingboard[current_mission_num].z);
-//
-//        		ROS_INFO("position*: %5.3f %5.3f %5.3f",pose_pub.pose.position.x,pose_pub.pose.position.y,pose_pub.pose.position.z);
-//				ROS_INFO("current position: %5.3f %5.3f %5.3f",current_pos.pose.position.x,current_pos.pose.position.y,current_pos.pose.position.z);
-
-                pose_pub.pose.position.x = board10.drawingboard[current_mission_num].x - VISION_SCAN_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);	/* TODO:switch to different board positions. -libn */
-                pose_pub.pose.position.y = board10.drawingboard[current_mission_num].y - VISION_SCAN_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-                pose_pub.pose.position.z = board10.drawingboard[current_mission_num].z + SAFE_HEIGHT_DISTANCE;
-
-//				ROS_INFO("distance: x = %5.3f y = %5.3f z = %5.3f\n",
-//						abs(current_pos.pose.position.x - board10.drawingboard[current_mission_num].x),
-//						abs(current_pos.pose.position.y - board10.drawingboard[current_mission_num].y),
-//						abs(current_pos.pose.position.z - (board10.drawingboard[current_mission_num].z+3)));
-
-//                if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 1) &&      // switch to next state
-//                   (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 1) &&
-//                   (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 1))
-                if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                                   current_pos.pose.position.y,pose_pub.pose.position.y,
-                                   current_pos.pose.position.z,pose_pub.pose.position.z) < 0.6)
-                {
-                    current_mission_state = mission_num_get_close; // current_mission_state++;
-					mission_last_time = ros::Time::now();
-                    #ifdef NO_ROS_DEBUG
-					ROS_INFO("mission switched well!");
-                    #endif
-				}
-        	}
-        	else
-        	{
-        		/* TODO: add scanning method! -libn */
-                current_mission_state = mission_scan_left_go; // current_mission_state++;
-                scan_to_get_pos = true;
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("fall into mission state: mission_num_scan_again");
-                #endif
-        	}
-			break;
-        case mission_num_locate:
-            pose_pub.pose.position.x = board10.drawingboard[current_mission_num].x - VISION_SCAN_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);	/* TODO:switch to different board positions. -libn */
-            pose_pub.pose.position.y = board10.drawingboard[current_mission_num].y - VISION_SCAN_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = board10.drawingboard[current_mission_num].z + SAFE_HEIGHT_DISTANCE;
-            /* TODO:update the position of the drawing board.  -libn */
-			relocate_valid = true;
-
-			if(relocate_valid)
-			{
-                if(ros::Time::now() - mission_last_time > ros::Duration(1))	/* hover for 5 seconds. -libn */
-                {
-                    current_mission_state = mission_num_get_close; // current_mission_state++;
-                    mission_last_time = ros::Time::now();
-                }
-			}
-//			else
-//			{
-//                if(ros::Time::now() - mission_last_time > ros::Duration(5))	/* wait for this operate 5 seconds at most. -libn */
-//				{
-//					/* TODO: add scanning method! -libn */
-//                    current_mission_state = mission_num_scan_again; // current_mission_state++;
-//				}
-//			}
-
-			break;
-        case mission_num_get_close:
-            pose_pub.pose.position.x = board10.drawingboard[current_mission_num].x - SPRAY_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);	/* TODO:switch to different board positions. -libn */
-            pose_pub.pose.position.y = board10.drawingboard[current_mission_num].y - SPRAY_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = board10.drawingboard[current_mission_num].z + SAFE_HEIGHT_DISTANCE;
-//            if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 0.2) &&      // switch to next state
-//               (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 0.2) &&
-//               (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 0.2))
-            if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                               current_pos.pose.position.y,pose_pub.pose.position.y,
-                               current_pos.pose.position.z,pose_pub.pose.position.z) < 0.15)
-            {
-                current_mission_state = mission_hover_before_spary; // current_mission_state++;
-            	mission_last_time = ros::Time::now();
-            }
-            break;
-        case mission_hover_before_spary:
-            static int hover_count = 0;
-            static int hover_acc_count = 0;
-            pose_pub.pose.position.x = board10.drawingboard[current_mission_num].x - SPRAY_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);	/* TODO:switch to different board positions. -libn */
-            pose_pub.pose.position.y = board10.drawingboard[current_mission_num].y - SPRAY_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = board10.drawingboard[current_mission_num].z + SAFE_HEIGHT_DISTANCE;
-
-            /*  */
-            if((ros::Time::now() - mission_last_time > ros::Duration(2)) &&
-               (hover_count == 0))
-            {
-                hover_count++;
-            }
-            if((ros::Time::now() - mission_last_time > ros::Duration(0.5)) &&
-               (hover_count > 0))
-            {
-//                if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 0.1) &&
-//                   (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 0.1) &&
-//                   (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 0.1))
-                if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                                   current_pos.pose.position.y,pose_pub.pose.position.y,
-                                   current_pos.pose.position.z,pose_pub.pose.position.z) < 0.1)
-                {
-                    hover_acc_count++;
-                    if(hover_acc_count > 3)
-                    {
-                        current_mission_state = mission_arm_spread; // current_mission_state++;
-                        hover_count = 0;
-                        hover_acc_count = 0;
-                        mission_last_time = ros::Time::now();
-                        break;
-                    }
-                }
-                else
-                {
-                    hover_acc_count = 0;
-                }
-                /* count for max time */
-                hover_count++;
-                if(hover_count > 10)
-                {
-                    /* force spray */
-                    current_mission_state = mission_arm_spread;
-                    hover_count = 0;
-                    hover_acc_count = 0;
-                    mission_last_time = ros::Time::now();
-                    break;
-                }
-                mission_last_time = ros::Time::now();
-                /* TODO: start spraying. -libn */
-            }
-            break;
-        case mission_arm_spread:
-            static int loop_count = 0;
-            static int acc_count = 0;   // enter 0.08 range
-            pose_pub.pose.position.x = board10.drawingboard[current_mission_num].x - SPRAY_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);	/* TODO:switch to different board positions. -libn */
-            pose_pub.pose.position.y = board10.drawingboard[current_mission_num].y - SPRAY_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = board10.drawingboard[current_mission_num].z + SAFE_HEIGHT_DISTANCE;
-            if((ros::Time::now() - mission_last_time > ros::Duration(1.5)) &&
-               (loop_count == 0))
-            {
-                loop_count++;
-            }
-            if((ros::Time::now() - mission_last_time > ros::Duration(0.5)) &&
-               (loop_count > 0))
-        	{
-//                if((abs(current_pos.pose.position.x - pose_pub.pose.position.x) < 0.04) &&
-//                   (abs(current_pos.pose.position.y - pose_pub.pose.position.y) < 0.04) &&
-//                   (abs(current_pos.pose.position.z - pose_pub.pose.position.z) < 0.04))
-                if(circle_distance(current_pos.pose.position.x,pose_pub.pose.position.x,
-                                   current_pos.pose.position.y,pose_pub.pose.position.y,
-                                   current_pos.pose.position.z,pose_pub.pose.position.z) < 0.05)
-                {
-                    acc_count++;
-                    if(acc_count > 5)
-                    {
-                        current_mission_state = mission_num_hover_spray; // current_mission_state++;
-                        loop_count = 0;
-                        acc_count = 0;
-                        mission_last_time = ros::Time::now();
-                        break;
-                    }
-                }
-                else
-                {
-                    acc_count = 0;
-                }
-                /* count for max time */
-                loop_count++;
-                if(loop_count > 10)
-                {
-                    /* force spray */
-                    current_mission_state = mission_num_hover_spray;
-                    loop_count = 0;
-                    acc_count = 0;
-                    mission_last_time = ros::Time::now();
-                    break;
-                }
-        		mission_last_time = ros::Time::now();
-        		/* TODO: start spraying. -libn */
-        	}
-            break;
-        case mission_num_hover_spray:
-            pose_pub.pose.position.x = board10.drawingboard[current_mission_num].x - SPRAY_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);	/* TODO:switch to different board positions. -libn */
-            pose_pub.pose.position.y = board10.drawingboard[current_mission_num].y - SPRAY_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-            pose_pub.pose.position.z = board10.drawingboard[current_mission_num].z + SAFE_HEIGHT_DISTANCE;
-
-            loop_timer_disable = true;
-            /* add height adjustment  --start. */
-            if(ros::Time::now() - mission_last_time > ros::Duration(0.5))	/* spray for 5 seconds. -libn */
-            {
-                pose_pub.pose.position.x = board10.drawingboard[current_mission_num].x - SPRAY_DISTANCE * cos(yaw_sp_calculated_m2p_data.yaw_sp);	/* TODO:switch to different board positions. -libn */
-                pose_pub.pose.position.y = board10.drawingboard[current_mission_num].y - SPRAY_DISTANCE * sin(yaw_sp_calculated_m2p_data.yaw_sp);
-                pose_pub.pose.position.z = board10.drawingboard[current_mission_num].z + SAFE_HEIGHT_DISTANCE - 0.05f;
-            }
-            /* add height adjustment  --stop. */
-
-            if(ros::Time::now() - mission_last_time > ros::Duration(3))	/* spray for 5 seconds. -libn */
-            {
-                current_mission_state = mission_hover_after_stretch_back; // current_mission_state++;
-                mission_last_time = ros::Time::now();
-                loop_timer_disable = false; /* enable loop_timer. */
-            }
-            break;
-        case mission_hover_after_stretch_back:
-            pose_pub.pose.position.x = current_pos.pose.position.x;	/* hover in current position. -libn */
-            pose_pub.pose.position.y = current_pos.pose.position.y;
-            pose_pub.pose.position.z = current_pos.pose.position.z;
-            if(ros::Time::now() - mission_last_time > ros::Duration(0.5f))	/* spray for 5 seconds. -libn */
-            {
-                loop++;	/* switch to next loop. -libn */
-                if(loop > 5)
-                {
-                    current_mission_state = mission_num_done; // current_mission_state++;
-                }
-                else
-                {
-                    current_mission_state = mission_observe_point_go; // current_mission_state++;
-                }
-            }
-            break;
-        case mission_num_done:
-        	pose_pub.pose.position.x = current_pos.pose.position.x;	/* hover in current position. -libn */
-        	pose_pub.pose.position.y = current_pos.pose.position.y;
-        	pose_pub.pose.position.z = current_pos.pose.position.z;
-        	/* TODO: mission check: if there are failures to be fixed -libn */
-            if(FAILURE_REPAIR && mission_failure_acount != 0)
-        	{
-        		current_mission_state = mission_fix_failure; // current_mission_state++;
-                #ifdef NO_ROS_DEBUG
-        		ROS_INFO("TODO: mission_fix_failure!");
-                #endif
-        	}
-        	else			/* mission is finished. -libn */
-        	{
-                current_mission_state = mission_return_home; // current_mission_state++;
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("going to mission_return_home");
-                #endif
-        		mission_last_time = ros::Time::now();
-        	}
-			break;
-        case mission_fix_failure:
-            /* TODO: add mission_failure_acount_fixed. -libn */
-            if((ros::Time::now() - mission_timer_start_time < ros::Duration(MAX_FLIGHT_TIME + mission_failure_acount * 30.0f ))
-                    && (mission_failure_acount != 0))
-            {
-                current_mission_num = failure[mission_failure_acount-1].num;
-                /* deal with failures. */
-                if((mission_num_search < failure[mission_failure_acount-1].state &&
-                    failure[mission_failure_acount-1].state < mission_arm_spread) ||
-                        failure[mission_failure_acount-1].state == mission_hover_before_spary)
-                {
-                    current_mission_state = mission_num_search;
-                }
-                mission_failure_acount--;
-
-            }
-            else if(mission_failure_acount == 0)
-            {
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("All failure fixed, return to home.");
-                #endif
-                current_mission_state = mission_return_home;
-            }
-			break;
-        case mission_force_return_home:
-            pose_pub.pose.position.x = current_pos.pose.position.x;
-            pose_pub.pose.position.y = current_pos.pose.position.y;
-            pose_pub.pose.position.z = current_pos.pose.position.z;
-            if(ros::Time::now() - mission_last_time > ros::Duration(2))	/* hover for 2 seconds. -libn */
-            {
-                current_mission_state = mission_return_home;    /* force to return to home! */
-            }
-            break;
-        case mission_return_home:
-			pose_pub.pose.position.x = setpoint_H.pose.position.x;
-			pose_pub.pose.position.y = setpoint_H.pose.position.y;
-			pose_pub.pose.position.z = setpoint_H.pose.position.z;
-//			ROS_INFO("start mission_return_home");
-//			ROS_INFO("setpoint_H*: %5.3f %5.3f %5.3f",setpoint_H.pose.position.x,setpoint_H.pose.position.y,setpoint_H.pose.position.z);
-//			ROS_INFO("current position --2 : %5.3f %5.3f %5.3f",current_pos.pose.position.x,current_pos.pose.position.y,current_pos.pose.position.z);
-			/* Bug! -libn */
-			if((abs(current_pos.pose.position.x - setpoint_H.pose.position.x) < 0.2) &&      // switch to next state
-			   (abs(current_pos.pose.position.y - setpoint_H.pose.position.y) < 0.2) &&
-			   (abs(current_pos.pose.position.z - setpoint_H.pose.position.z) < 0.2) &&
-               (ros::Time::now() - mission_last_time > ros::Duration(1)))		/* Bug: mission_last_time is not necessary! -libn */
-			{
-                #ifdef NO_ROS_DEBUG
-                ROS_INFO("start mission_hover_only");
-                #endif
-                current_mission_state = mission_hover_only; // current_mission_state++;
-				mission_last_time = ros::Time::now();
-			}
-			break;
-        case mission_hover_only:
-			pose_pub.pose.position.x = setpoint_H.pose.position.x;
-			pose_pub.pose.position.y = setpoint_H.pose.position.y;
-			pose_pub.pose.position.z = setpoint_H.pose.position.z;
-            if(ros::Time::now() - mission_last_time > ros::Duration(1))	/* hover for 2 seconds. -libn */
-			{
-				current_mission_state = land; // current_mission_state++;
-			}
-			break;
-        case land:
-			break;
-    }
-
-}
@@ -0,0 +1,110 @@
+/**
+* @file     : offboard_bootstrap.cpp
+* @brief    : start-up: request OFFBOARD and arming as soon as PX4 accepts them.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/offboard_bootstrap.h>
+
+BootstrapConfig bootstrap_default_config()
+{
+    BootstrapConfig config;
+    config.min_stream_time = 1.0;
+    config.retry_interval = 0.5;
+    config.request_offboard = false;
+    config.request_arm = false;
+    return config;
+}
+
+OffboardBootstrap::OffboardBootstrap(const BootstrapConfig& config, const ros::Time& start)
+    : config_(config),
+      start_(start),
+      connected_at_(start),
+      last_request_(start),
+      last_request_type_(BOOTSTRAP_NONE),
+      connected_(false),
+      stream_ready_(false),
+      done_(false),
+      time_connected_(-1.0),
+      time_stream_ready_(-1.0),
+      time_offboard_(-1.0),
+      time_armed_(-1.0)
+{
+}
+
+BootstrapRequest OffboardBootstrap::update(const VehicleState& state, const ros::Time& now, bool request_pending)
+{
+    double elapsed = (now - start_).toSec();
+
+    if(!state.connected)
+    {
+        /* FCU lost: stream time counts again from the next connection. */
+        connected_ = false;
+        stream_ready_ = false;
+        return BOOTSTRAP_NONE;
+    }
+    if(!connected_)
+    {
+        connected_ = true;
+        connected_at_ = now;
+        if(time_connected_ < 0)
+        {
+            time_connected_ = elapsed;
+        }
+    }
+    if(!stream_ready_ && (now - connected_at_).toSec() >= config_.min_stream_time)
+    {
+        stream_ready_ = true;
+        if(time_stream_ready_ < 0)
+        {
+            time_stream_ready_ = elapsed;
+        }
+    }
+
+    if(state.mode == MODE_OFFBOARD && time_offboard_ < 0)
+    {
+        time_offboard_ = elapsed;
+    }
+    if(state.mode == MODE_OFFBOARD && state.armed)
+    {
+        if(!done_ && time_armed_ < 0)
+        {
+            time_armed_ = elapsed;
+        }
+        done_ = true;
+        return BOOTSTRAP_NONE;
+    }
+    done_ = false;
+
+    if(!stream_ready_ || request_pending)
+    {
+        return BOOTSTRAP_NONE;
+    }
+
+    BootstrapRequest request = BOOTSTRAP_NONE;
+    if(state.mode != MODE_OFFBOARD)
+    {
+        request = config_.request_offboard ? BOOTSTRAP_SET_OFFBOARD : BOOTSTRAP_NONE;
+    }
+    else if(!state.armed)
+    {
+        request = config_.request_arm ? BOOTSTRAP_ARM : BOOTSTRAP_NONE;
+    }
+
+    /* the next request goes out at once, the same one again only after retry_interval. */
+    if(request == BOOTSTRAP_NONE
+       || (request == last_request_type_ && (now - last_request_).toSec() < config_.retry_interval))
+    {
+        return BOOTSTRAP_NONE;
+    }
+    last_request_ = now;
+    last_request_type_ = request;
+    return request;
+}
+
+void OffboardBootstrap::report() const
+{
+    ROS_INFO("start-up: connected %.2f s, stream ready %.2f s, OFFBOARD %.2f s, armed %.2f s",
+             time_connected_, time_stream_ready_, time_offboard_, time_armed_);
+}
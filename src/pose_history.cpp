@@ -0,0 +1,77 @@
+/**
+* @file     : pose_history.cpp
+* @brief    : pose history: ring buffer of local positions, interpolated by stamp.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/pose_history.h>
+
+void pose_history_reset(PoseHistory& history)
+{
+    history.head = 0;
+    history.count = 0;
+}
+
+/* i-th oldest pose. */
+static int slot(const PoseHistory& history, int i)
+{
+    return (history.head - history.count + i + POSE_HISTORY_SIZE) % POSE_HISTORY_SIZE;
+}
+
+bool pose_history_push(PoseHistory& history, const ros::Time& stamp, const geometry_msgs::Point& position)
+{
+    if(history.count > 0 && stamp <= history.stamp[slot(history, history.count - 1)])
+    {
+        return false;
+    }
+    history.stamp[history.head] = stamp;
+    history.position[history.head] = position;
+    history.head = (history.head + 1) % POSE_HISTORY_SIZE;
+    if(history.count < POSE_HISTORY_SIZE)
+    {
+        history.count++;
+    }
+    return true;
+}
+
+PoseLookup pose_history_at(const PoseHistory& history, const ros::Time& stamp, geometry_msgs::Point& position)
+{
+    if(history.count == 0)
+    {
+        return POSE_NONE;
+    }
+    const int latest = slot(history, history.count - 1);
+    if(stamp.isZero() || stamp >= history.stamp[latest])
+    {
+        position = history.position[latest];
+        return POSE_LATEST;
+    }
+    const int oldest = slot(history, 0);
+    if(stamp <= history.stamp[oldest])
+    {
+        position = history.position[oldest];
+        return POSE_OLDEST;
+    }
+
+    /* binary search: stamp[lo] <= stamp < stamp[hi], oldest first. */
+    int lo = 0, hi = history.count - 1;
+    while(hi - lo > 1)
+    {
+        int mid = (lo + hi) / 2;
+        if(history.stamp[slot(history, mid)] <= stamp)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    const int a = slot(history, lo), b = slot(history, hi);
+    const double t = (stamp - history.stamp[a]).toSec() / (history.stamp[b] - history.stamp[a]).toSec();
+    position.x = history.position[a].x + t * (history.position[b].x - history.position[a].x);
+    position.y = history.position[a].y + t * (history.position[b].y - history.position[a].y);
+    position.z = history.position[a].z + t * (history.position[b].z - history.position[a].z);
+    return POSE_INTERPOLATED;
+}
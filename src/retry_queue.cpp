@@ -0,0 +1,106 @@
+/**
+* @file     : retry_queue.cpp
+* @brief    : failure retry queue: per-board entries, cheapest affordable entry first.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/retry_queue.h>
+
+void retry_reset(RetryQueue& queue)
+{
+    queue.count = 0;
+    queue.recorded = 0;
+    queue.started = 0;
+    queue.recovered = 0;
+    queue.dropped = 0;
+}
+
+int retry_policy_attempts(RetryPolicy policy)
+{
+    switch(policy)
+    {
+    case RETRY_APPROACH:    return 2;
+    case RETRY_HOVER:       return 1;
+    case RETRY_SCAN:        return 1;
+    case RETRY_NONE:        return 0;
+    }
+    return 0;
+}
+
+const char* retry_policy_name(RetryPolicy policy)
+{
+    switch(policy)
+    {
+    case RETRY_APPROACH:    return "approach";
+    case RETRY_HOVER:       return "hover";
+    case RETRY_SCAN:        return "scan";
+    case RETRY_NONE:        return "none";
+    }
+    return "unknown";
+}
+
+static RetryEntry* find(RetryQueue& queue, int num)
+{
+    for(int i = 0; i < queue.count; ++i)
+    {
+        if(queue.entry[i].num == num)
+        {
+            return &queue.entry[i];
+        }
+    }
+    return 0;
+}
+
+bool retry_push(RetryQueue& queue, int num, int state, RetryPolicy policy, int attempts)
+{
+    queue.recorded++;
+    if(policy == RETRY_NONE || num < 0 || num >= RETRY_BOARDS_MAX)
+    {
+        queue.dropped++;
+        return false;
+    }
+    RetryEntry* entry = find(queue, num);
+    if(!entry)
+    {
+        entry = &queue.entry[queue.count++];
+        entry->num = num;
+        entry->attempts = 0;
+    }
+    if(attempts > entry->attempts)
+    {
+        entry->attempts = attempts;
+    }
+    entry->state = state;
+    entry->policy = policy;
+    entry->max_attempts = retry_policy_attempts(policy);
+    entry->cost = 0.0;
+    if(entry->attempts >= entry->max_attempts)
+    {
+        *entry = queue.entry[--queue.count];    /* order is not kept: retry_pop() compares costs. */
+        queue.dropped++;
+        return false;
+    }
+    return true;
+}
+
+bool retry_pop(RetryQueue& queue, double budget, RetryEntry& retry)
+{
+    int best = -1;
+    for(int i = 0; i < queue.count; ++i)
+    {
+        if(queue.entry[i].cost <= budget && (best < 0 || queue.entry[i].cost < queue.entry[best].cost))
+        {
+            best = i;
+        }
+    }
+    if(best < 0)
+    {
+        return false;
+    }
+    retry = queue.entry[best];
+    retry.attempts++;
+    queue.entry[best] = queue.entry[--queue.count];
+    queue.started++;
+    return true;
+}
@@ -0,0 +1,90 @@
+/**
+* @file     : setpoint_streamer.cpp
+* @brief    : setpoint streamer: minimum-jerk trajectory between mission targets.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/setpoint_streamer.h>
+
+#include <math.h>
+
+SetpointStreamer::SetpointStreamer(const TrajectoryLimits& limits)
+: limits_(limits), handoff_(false)
+{
+}
+
+void SetpointStreamer::reset(const geometry_msgs::Point& position, const ros::Time& now)
+{
+    trajectory_.reset(position);
+    start_ = now;
+    handoff_ = false;
+}
+
+void SetpointStreamer::reset(const geometry_msgs::Point& position, const geometry_msgs::Vector3& velocity, const ros::Time& now)
+{
+    reset(position, now);
+    handoff_state_.position = position;
+    handoff_state_.velocity = velocity;
+    handoff_state_.acceleration = geometry_msgs::Vector3();
+    handoff_ = true;
+}
+
+void SetpointStreamer::set_target(const geometry_msgs::Point& target, const ros::Time& now)
+{
+    const geometry_msgs::Point& to = trajectory_.target();
+    if(target.x == to.x && target.y == to.y && target.z == to.z)
+    {
+        return;     /* same target: keep streaming the planned trajectory. */
+    }
+    if(limits_.max_velocity <= 0.0)
+    {
+        reset(target, now);     /* shaping disabled: step. */
+        return;
+    }
+    TrajectoryState from = handoff_ ? handoff_state_ : sample_state(now);
+    trajectory_.plan(from, target, limits_);
+    start_ = now;
+    handoff_ = false;
+}
+
+geometry_msgs::Point SetpointStreamer::sample(const ros::Time& now) const
+{
+    return trajectory_.sample((now - start_).toSec()).position;
+}
+
+TrajectoryState SetpointStreamer::sample_state(const ros::Time& now) const
+{
+    return trajectory_.sample((now - start_).toSec());
+}
+
+void SetpointStreamer::position_target(const ros::Time& now, double yaw, state_machine::PositionTarget& target) const
+{
+    TrajectoryState state = sample_state(now);
+    target.header.stamp = now;
+    target.coordinate_frame = state_machine::PositionTarget::FRAME_LOCAL_NED;     /* mavros: ENU in, NED out. */
+    target.type_mask = POSITION_TARGET_FEED_FORWARD;
+    target.position = state.position;
+    target.velocity = state.velocity;
+    target.acceleration_or_force = state.acceleration;
+    target.yaw = yaw;
+    target.yaw_rate = 0.0f;
+}
+
+void velocity_target(const ros::Time& now, const geometry_msgs::Vector3& velocity, double yaw,
+                     state_machine::PositionTarget& target)
+{
+    target.header.stamp = now;
+    target.coordinate_frame = state_machine::PositionTarget::FRAME_LOCAL_NED;
+    target.type_mask = POSITION_TARGET_VELOCITY;
+    target.position = geometry_msgs::Point();
+    target.velocity = velocity;
+    target.acceleration_or_force = geometry_msgs::Vector3();
+    target.yaw = yaw;
+    target.yaw_rate = 0.0f;
+}
+
+double quaternion_yaw(const geometry_msgs::Quaternion& q)
+{
+    return atan2(2.0*(q.w*q.z + q.x*q.y), 1.0 - 2.0*(q.y*q.y + q.z*q.z));
+}
@@ -0,0 +1,75 @@
+/**
+* @file     : settle_detector.cpp
+* @brief    : settle detector: sliding window statistics of distance to setpoint and speed.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/settle_detector.h>
+
+#include <math.h>
+
+void settle_reset(SettleDetector& detector, int state, const ros::Time& now)
+{
+    detector.state = state;
+    detector.start = now;
+    detector.head = 0;
+    detector.count = 0;
+    detector.done = false;
+    detector.forced = false;
+}
+
+double settle_dwell(const SettleDetector& detector, const ros::Time& now)
+{
+    return (now - detector.start).toSec();
+}
+
+void settle_update(SettleDetector& detector, const SettleConfig& config, const ros::Time& now, double error, double speed)
+{
+    detector.stamp[detector.head] = now;
+    detector.error[detector.head] = error;
+    detector.speed[detector.head] = speed;
+    detector.head = (detector.head + 1) % SETTLE_SAMPLES_MAX;
+    if(detector.count < SETTLE_SAMPLES_MAX)
+    {
+        detector.count++;
+    }
+
+    double dwell = settle_dwell(detector, now);
+    if(dwell >= config.max_dwell)
+    {
+        detector.done = true;
+        detector.forced = true;
+        return;
+    }
+    if(dwell < config.min_dwell || dwell < config.window)
+    {
+        return;
+    }
+
+    /* samples within the window, newest first. */
+    int n = 0;
+    double sum = 0.0, sum2 = 0.0, speed_max = 0.0;
+    ros::Time oldest = now;
+    for(int i = 0; i < detector.count; ++i)
+    {
+        int k = (detector.head - 1 - i + SETTLE_SAMPLES_MAX) % SETTLE_SAMPLES_MAX;
+        if((now - detector.stamp[k]).toSec() > config.window)
+        {
+            break;
+        }
+        sum += detector.error[k];
+        sum2 += detector.error[k] * detector.error[k];
+        speed_max = fmax(speed_max, detector.speed[k]);
+        oldest = detector.stamp[k];
+        n++;
+    }
+    /* window not covered yet(samples kept are too few for the window). */
+    if(n < 3 || (now - oldest).toSec() < 0.8 * config.window)
+    {
+        return;
+    }
+    double mean = sum / n;
+    double variance = fmax(0.0, sum2 / n - mean * mean);
+    detector.done = mean + 2.0 * sqrt(variance) < config.radius && speed_max < config.speed;
+}
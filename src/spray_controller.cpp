@@ -0,0 +1,102 @@
+/**
+* @file     : spray_controller.cpp
+* @brief    : spray phase: payload valve opened when settled, closed after the spray time.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/spray_controller.h>
+
+SprayConfig spray_default_config()
+{
+    SprayConfig config;
+    config.duration = SPRAY_DURATION;
+    config.max_wait = SPRAY_WAIT_MAX;
+    config.channel = SPRAY_CHANNEL;
+    config.on = 1.0f;
+    config.off = -1.0f;
+    return config;
+}
+
+static void valve(SprayController& spray, const SprayConfig& config, const ros::Time& now, bool open)
+{
+    spray.output.header.stamp = now;
+    spray.output.group_mix = state_machine::ActuatorControl::PX4_MIX_PAYLOAD;
+    for(int i = 0; i < 8; ++i)
+    {
+        spray.output.controls[i] = 0.0f;
+    }
+    spray.output.controls[config.channel] = open ? config.on : config.off;
+    spray.output_pending = true;
+}
+
+void spray_reset(SprayController& spray, const SprayConfig& config)
+{
+    spray.phase = SPRAY_IDLE;
+    spray.board = -1;
+    spray.forced = false;
+    valve(spray, config, ros::Time(0), false);
+}
+
+void spray_start(SprayController& spray, const SprayConfig& config, int board, const ros::Time& now, bool settled)
+{
+    spray.phase = SPRAY_WAIT;
+    spray.board = board;
+    spray.enter = now;
+    spray.on_at = now;
+    spray.off_at = now;
+    spray.forced = false;
+    if(settled)
+    {
+        spray_update(spray, config, now, true);
+    }
+}
+
+void spray_update(SprayController& spray, const SprayConfig& config, const ros::Time& now, bool settled)
+{
+    if(spray.phase == SPRAY_WAIT)
+    {
+        bool waited = (now - spray.enter).toSec() >= config.max_wait;
+        if(!settled && !waited)
+        {
+            return;
+        }
+        spray.phase = SPRAY_ON;
+        spray.on_at = now;
+        spray.forced = !settled;
+        valve(spray, config, now, true);
+    }
+    /* checked in the tick the valve opened too: duration <= 0 closes it at once.
+     * 1ms: clock steps of exactly one period are not missed by rounding. */
+    if(spray.phase == SPRAY_ON && (now - spray.on_at).toSec() >= config.duration - 1e-3)
+    {
+        spray.phase = SPRAY_DONE;
+        spray.off_at = now;
+        valve(spray, config, now, false);
+    }
+}
+
+void spray_abort(SprayController& spray, const SprayConfig& config, const ros::Time& now)
+{
+    if(spray.phase == SPRAY_ON)
+    {
+        spray.off_at = now;
+        valve(spray, config, now, false);
+    }
+    else if(spray.phase == SPRAY_WAIT)
+    {
+        spray.on_at = spray.off_at = now;
+    }
+    if(spray.phase != SPRAY_IDLE)
+    {
+        spray.phase = SPRAY_DONE;
+    }
+}
+
+void spray_record(const SprayController& spray, SprayRecord& record)
+{
+    record.count++;
+    record.latency = (spray.on_at - spray.enter).toSec();
+    record.sprayed = (spray.off_at - spray.on_at).toSec();
+    record.forced = spray.forced;
+}
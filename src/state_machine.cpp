@@ -10,9 +10,14 @@
 #include <geometry_msgs/PoseStamped.h>  /* message type of /mavros/local_position/pose (P.S. It is included in dir: /opt/ros/indigo/share/geometry_msgs/msg) -libn */
 #include <state_machine/ActuatorControl.h> /* add actuator_control output */
 #include <stdio.h>
+#include <math.h>
 #include <state_machine/CommandTOL.h>	/* head file for takeoff&land-command service -libn */
 #include <state_machine/Setpoint.h>
 #include <state_machine/DrawingBoard.h>
+#include <state_machine/mission_engine.h>
+#include <state_machine/command_executor.h>
+#include <state_machine/offboard_bootstrap.h>
+#include <state_machine/vehicle_state.h>
 
 #define switch_mode 0	/* 1:real uav;0:simulation. -libn Aug 25, 2016 */
 #if switch_mode == 0
@@ -22,8 +27,6 @@
 /* added for simulation -stop. -libn Aug 25, 2016 */
 #endif
 
-void state_machine_func(void);
-
 // state machine's states
 static const int POS_A = 0;
 static const int POS_B = 1;
@@ -32,8 +35,52 @@ static const int POS_D = 3;
 static const int LAND  = 4;
 static const int TAKEOFF  = 5;	/* TODO! for future use. -libn <Aug 11, 2016 9:54:13 AM> */
 
+/* context of the 4 setpoints flight. */
+struct FlightContext
+{
+	geometry_msgs::PoseStamped setpoint[4];	/* 4 setpoints: A,B,C,D. -libn <Aug 15, 2016 11:04:14 AM> */
+	geometry_msgs::PoseStamped current_pos;
+	geometry_msgs::PoseStamped setpoint_pub;	/* position setpoint to publish */
+	ros::Publisher local_pos_setpoint_pub;	/* used to publish local_pos_setpoint -libn */
+};
+FlightContext flight;
+
+/* fly to setpoint POS: publish it as desired position. */
+template <int POS>
+void fly_to(FlightContext& ctx)
+{
+	ctx.setpoint_pub = ctx.setpoint[POS];			// set expected position
+	ctx.local_pos_setpoint_pub.publish(ctx.setpoint_pub);      // publish desired position
+}
+
+template <int POS>
+bool reached(const FlightContext& ctx)
+{
+	return (fabs(ctx.current_pos.pose.position.x - ctx.setpoint[POS].pose.position.x) < 0.2) &&      // switch to next state
+	       (fabs(ctx.current_pos.pose.position.y - ctx.setpoint[POS].pose.position.y) < 0.2) &&
+	       (fabs(ctx.current_pos.pose.position.z - ctx.setpoint[POS].pose.position.z) < 0.2);
+}
+
+static constexpr state_machine::MissionState<FlightContext> flight_states[] =
+{
+	{TAKEOFF,	NULL},	/* Not used! just in case.  -libn <Aug 11, 2016 9:56:44 AM> */
+	{POS_A,		fly_to<POS_A>},
+	{POS_B,		fly_to<POS_B>},
+	{POS_C,		fly_to<POS_C>},
+	{POS_D,		fly_to<POS_D>},
+	{LAND,		NULL},
+};
+
+static constexpr state_machine::MissionTransition<FlightContext> flight_transitions[] =
+{
+	{POS_A,	reached<POS_A>,	NULL,	POS_B,	state_machine::MISSION_EVENT_NONE},
+	{POS_B,	reached<POS_B>,	NULL,	POS_C,	state_machine::MISSION_EVENT_NONE},
+	{POS_C,	reached<POS_C>,	NULL,	POS_D,	state_machine::MISSION_EVENT_NONE},
+	{POS_D,	reached<POS_D>,	NULL,	LAND,	state_machine::MISSION_EVENT_NONE},
+};
+
 // current positon state, init state is takeoff and go to setpoint_A
-int current_pos_state = POS_A;
+state_machine::MissionEngine<FlightContext, TAKEOFF> flight_state_machine(flight_states, flight_transitions, POS_A);
 
 state_machine::Setpoint setpoint_indexed;
 void printSetpointIndexedCallback(const state_machine::Setpoint::ConstPtr& msg)
@@ -49,12 +96,6 @@ void DrawingBoardCallback(const state_machine::DrawingBoard::ConstPtr& msg)
 	board = *msg;
 }
 
-/* 4 setpoints. -libn <Aug 15, 2016 11:04:14 AM> */
-geometry_msgs::PoseStamped setpoint_A;
-geometry_msgs::PoseStamped setpoint_B;
-geometry_msgs::PoseStamped setpoint_C;
-geometry_msgs::PoseStamped setpoint_D;
-
 /* 10 drawing board position. -libn <Aug 15, 2016 11:20:52 AM> */
 state_machine::DrawingBoard board_1;
 state_machine::DrawingBoard board_2;
@@ -68,9 +109,8 @@ state_machine::DrawingBoard board_9;
 state_machine::DrawingBoard board_0;
 
 // local position msg callback function
-geometry_msgs::PoseStamped current_pos;
 void pos_cb(const geometry_msgs::PoseStamped::ConstPtr& msg){
-    current_pos = *msg;
+    flight.current_pos = *msg;
 }
 
 // state msg callback function
@@ -79,11 +119,6 @@ void state_cb(const state_machine::State::ConstPtr& msg){
     current_state = *msg;
 }
 
-// position setpoint to publish
-geometry_msgs::PoseStamped setpoint_pub;
-// pulisher: used to publish local_pos_setpoint -libn
-ros::Publisher local_pos_setpoint_pub;
-
 int count;	/* to reduce display freq. -libn <Aug 15, 2016 10:02:32 PM> */
 int main(int argc, char **argv)
 {
@@ -117,11 +152,9 @@ int main(int argc, char **argv)
 	ros::Subscriber local_pos_sub = nh.subscribe<geometry_msgs::PoseStamped>("mavros/local_position/pose", 10, pos_cb);
 
 	/* publish local_pos_setpoint -libn <Aug 11, 2016 10:05:05 AM> */
-	local_pos_setpoint_pub = nh.advertise<geometry_msgs::PoseStamped>("mavros/setpoint_position/local", 10);
+	flight.local_pos_setpoint_pub = nh.advertise<geometry_msgs::PoseStamped>("mavros/setpoint_position/local", 10);
 
-	#if switch_mode == 0
-	ros::Time last_request = ros::Time::now();
-	#else
+	#if switch_mode == 1
 	ros::Time landing_last_request = ros::Time::now();
 	#endif
 
@@ -129,21 +162,38 @@ int main(int argc, char **argv)
     // ros::ServiceClient takeoff_client = nh.serviceClient<state_machine::CommandTOL>("mavros/cmd/takeoff");
     ros::ServiceClient land_client = nh.serviceClient<state_machine::CommandTOL>("mavros/cmd/land");
 
-    // wait for FCU connection
-	while(ros::ok() && !current_state.connected){
-		ros::spinOnce();
-		rate.sleep();
-	}
+    /* service calls run on the executor thread: a slow mavros answer does not stop setpoint publishing. */
+    CommandExecutor command_executor;
+    CommandOptions command_options = command_default_options();
+	#if switch_mode == 0
+    /* single attempt: the bootstrap retries on the next vehicle state. */
+    command_options.max_attempts = 1;
+    command_options.timeout = 1.0;
+    std::future<CommandResult> bootstrap_result;
+	#else
+    std::future<CommandResult> land_result;
+	#endif
 
-    setpoint_pub.pose.position.x = 0;
-    setpoint_pub.pose.position.y = 0;
-    setpoint_pub.pose.position.z = 3;
+    /* request OFFBOARD and arming as soon as PX4 accepts them(simulation only). */
+    BootstrapConfig bootstrap_config = bootstrap_default_config();
+	#if switch_mode == 0
+    bootstrap_config.request_offboard = true;
+    bootstrap_config.request_arm = true;
+	#endif
+    OffboardBootstrap bootstrap(bootstrap_config, ros::Time::now());
+    VehicleState vehicle_state;
+
+    flight.setpoint_pub.pose.position.x = 0;
+    flight.setpoint_pub.pose.position.y = 0;
+    flight.setpoint_pub.pose.position.z = 3;
 
-	//send a few setpoints before starting  --> for safety
-    ROS_INFO("sending 100 desired_poses. Wait for a while.");
-	for(int i = 100; ros::ok() && i > 0; --i){
-		local_pos_setpoint_pub.publish(setpoint_pub);
+	// wait for FCU connection, send setpoints before starting  --> for safety
+    ROS_INFO("sending desired_poses until FCU is ready.");
+	while(ros::ok() && !bootstrap.stream_ready()){
+		flight.local_pos_setpoint_pub.publish(flight.setpoint_pub);
 		ros::spinOnce();
+		vehicle_state_update(vehicle_state, current_state);
+		bootstrap.update(vehicle_state, ros::Time::now(), false);
 		rate.sleep();
 	}
 
@@ -166,24 +216,21 @@ int main(int argc, char **argv)
 	{
 		# if switch_mode == 0
 		/* added for simulation -start. -libn Aug 25, 2016 */
-		if( current_state.mode != "OFFBOARD" && (ros::Time::now() - last_request > ros::Duration(5.0)))
+		vehicle_state_update(vehicle_state, current_state);
+		bool bootstrap_done = bootstrap.done();
+		BootstrapRequest request = bootstrap.update(vehicle_state, ros::Time::now(), command_pending(bootstrap_result));
+		if(request == BOOTSTRAP_SET_OFFBOARD)
 		{
-			if( set_mode_client.call(offb_set_mode) &&
-			offb_set_mode.response.success){
-			ROS_INFO("Offboard enabled");
+			bootstrap_result = command_executor.submit("mavros/set_mode", set_mode_client, offb_set_mode, command_options);
 		}
-			last_request = ros::Time::now();
+		else if(request == BOOTSTRAP_ARM)
+		{
+			bootstrap_result = command_executor.submit("mavros/cmd/arming", arming_client, arm_cmd, command_options);
 		}
-		else
+		if(bootstrap.done() && !bootstrap_done)
 		{
-			if( !current_state.armed && (ros::Time::now() - last_request > ros::Duration(5.0)))
-			{
-				if( arming_client.call(arm_cmd) && arm_cmd.response.success)
-				{
-					ROS_INFO("Vehicle armed");
-				}
-				last_request = ros::Time::now();
-			}
+			ROS_INFO("Offboard enabled, vehicle armed");
+			bootstrap.report();
 		}
 		/* added for simulation -stop. -libn Aug 25, 2016 */
 		# endif
@@ -200,24 +247,24 @@ int main(int argc, char **argv)
         switch(setpoint_indexed.index)
         {
         	case 1:
-        		setpoint_A.pose.position.x = setpoint_indexed.x;
-				setpoint_A.pose.position.y = setpoint_indexed.y;
-				setpoint_A.pose.position.z = setpoint_indexed.z;
+        		flight.setpoint[POS_A].pose.position.x = setpoint_indexed.x;
+				flight.setpoint[POS_A].pose.position.y = setpoint_indexed.y;
+				flight.setpoint[POS_A].pose.position.z = setpoint_indexed.z;
 				break;
         	case 2:
-        		setpoint_B.pose.position.x = setpoint_indexed.x;
-				setpoint_B.pose.position.y = setpoint_indexed.y;
-				setpoint_B.pose.position.z = setpoint_indexed.z;
+        		flight.setpoint[POS_B].pose.position.x = setpoint_indexed.x;
+				flight.setpoint[POS_B].pose.position.y = setpoint_indexed.y;
+				flight.setpoint[POS_B].pose.position.z = setpoint_indexed.z;
 				break;
         	case 3:
-        		setpoint_C.pose.position.x = setpoint_indexed.x;
-				setpoint_C.pose.position.y = setpoint_indexed.y;
-				setpoint_C.pose.position.z = setpoint_indexed.z;
+        		flight.setpoint[POS_C].pose.position.x = setpoint_indexed.x;
+				flight.setpoint[POS_C].pose.position.y = setpoint_indexed.y;
+				flight.setpoint[POS_C].pose.position.z = setpoint_indexed.z;
 				break;
         	case 4:
-        		setpoint_D.pose.position.x = setpoint_indexed.x;
-				setpoint_D.pose.position.y = setpoint_indexed.y;
-				setpoint_D.pose.position.z = setpoint_indexed.z;
+        		flight.setpoint[POS_D].pose.position.x = setpoint_indexed.x;
+				flight.setpoint[POS_D].pose.position.y = setpoint_indexed.y;
+				flight.setpoint[POS_D].pose.position.z = setpoint_indexed.z;
 				break;
         	default:
         		ROS_INFO("setpoint index error!");
@@ -300,27 +347,28 @@ int main(int argc, char **argv)
         }
 		#endif
 
-        state_machine_func();	/* Run state_machine. -libn <Aug 11, 2016 10:01:12 AM> */
+        flight_state_machine.tick(flight);	/* Run state_machine. -libn <Aug 11, 2016 10:01:12 AM> */
 
     	count++;
     	if(count >= 20)
     	{
     		count = 0;
-    		ROS_INFO("current_pos_state: %d",current_pos_state);
+    		ROS_INFO("current_pos_state: %d",flight_state_machine.state());
     	}
 
 		#if switch_mode == 1
         // landing
-        if(current_pos_state == LAND){
+        if(flight_state_machine.state() == LAND){
 
-            if( current_state.mode != "AUTO.LAND" &&
+            if( current_state.mode != "AUTO.LAND" && !command_pending(land_result) &&
             (ros::Time::now() - landing_last_request > ros::Duration(5.0))){
-            if(land_client.call(landing_cmd) &&
-                landing_cmd.response.success){
-                ROS_INFO("AUTO LANDING!");
-            }
+            land_result = command_executor.submit("mavros/cmd/land", land_client, landing_cmd, command_options);
             landing_last_request = ros::Time::now();
             }
+        }
+        if(command_ready(land_result) && land_result.get().status == COMMAND_SUCCESS)
+        {
+            ROS_INFO("AUTO LANDING!");
         }
 		#endif
 
@@ -329,62 +377,7 @@ int main(int argc, char **argv)
 
 	}
 
-
+	command_executor.report();
 	return 0;
 		
 }
-
-
-// task state machine
-void state_machine_func(void)
-{
-	switch(current_pos_state){
-
-    	case TAKEOFF:	/* Not used! just in case.  -libn <Aug 11, 2016 9:56:44 AM> */
-    		break;
-
-        case POS_A:
-            setpoint_pub = setpoint_A;			// set expected position
-        	local_pos_setpoint_pub.publish(setpoint_pub);      // publish pos A (desired position)
-            if((abs(current_pos.pose.position.x - setpoint_A.pose.position.x) < 0.2) &&      // switch to next state
-               (abs(current_pos.pose.position.y - setpoint_A.pose.position.y) < 0.2) &&
-               (abs(current_pos.pose.position.z - setpoint_A.pose.position.z) < 0.2))
-               {
-                    current_pos_state = POS_B; // current_pos_state++;
-               }
-            break;
-        case POS_B:
-            setpoint_pub = setpoint_B;			// set expected position
-        	local_pos_setpoint_pub.publish(setpoint_pub);      // publish pos B (desired position)
-            if((abs(current_pos.pose.position.x - setpoint_B.pose.position.x) < 0.2) &&      // switch to next state
-               (abs(current_pos.pose.position.y - setpoint_B.pose.position.y) < 0.2) &&
-               (abs(current_pos.pose.position.z - setpoint_B.pose.position.z) < 0.2))
-               {
-            	current_pos_state = POS_C; // current_pos_state++;
-               }
-            break;
-        case POS_C:
-            setpoint_pub = setpoint_C;			// set expected position
-        	local_pos_setpoint_pub.publish(setpoint_pub);      // publish pos C (desired position)
-			if((abs(current_pos.pose.position.x - setpoint_C.pose.position.x) < 0.2) &&      // switch to next state
-			   (abs(current_pos.pose.position.y - setpoint_C.pose.position.y) < 0.2) &&
-			   (abs(current_pos.pose.position.z - setpoint_C.pose.position.z) < 0.2))
-			   {
-					current_pos_state = POS_D; // current_pos_state++;
-			   }
-			break;
-        case POS_D:
-            setpoint_pub = setpoint_D;			// set expected position
-        	local_pos_setpoint_pub.publish(setpoint_pub);      // publish pos D (desired position)
-			if((abs(current_pos.pose.position.x - setpoint_D.pose.position.x) < 0.2) &&      // switch to next state
-			   (abs(current_pos.pose.position.y - setpoint_D.pose.position.y) < 0.2) &&
-			   (abs(current_pos.pose.position.z - setpoint_D.pose.position.z) < 0.2))
-			   {
-				current_pos_state = LAND; // current_pos_state++;
-			   }
-			break;
-        case LAND:
-            break;
-    }
-
-}
@@ -0,0 +1,239 @@
+/**
+* @file     : trajectory.cpp
+* @brief    : minimum-jerk trajectory to a mission target with velocity and acceleration limits.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/trajectory.h>
+
+#include <math.h>
+
+#define MIN_JERK_PEAK 1.875         /* peak/mean of a minimum-jerk ramp(velocity in moves, acceleration in ramps). */
+#define TRAJECTORY_CHECK_SAMPLES 16 /* quintic: samples checked against the limits. */
+#define TRAJECTORY_STRETCH 1.15     /* quintic: duration growth while a limit is exceeded. */
+#define TRAJECTORY_STRETCH_MAX 30
+
+TrajectoryLimits trajectory_default_limits(double min_duration)
+{
+    TrajectoryLimits limits;
+    limits.max_velocity = TRAJECTORY_VELOCITY_MAX;
+    limits.max_acceleration = TRAJECTORY_ACCELERATION_MAX;
+    limits.min_duration = min_duration;
+    return limits;
+}
+
+/* boundary (p0,v0,a0) -> (p1,0,0) in time T. */
+static void quintic(double p0, double v0, double a0, double p1, double T, double c[6])
+{
+    double d = p1 - p0;
+    double T2 = T*T;
+    double T3 = T2*T;
+    c[0] = p0;
+    c[1] = v0;
+    c[2] = 0.5*a0;
+    c[3] = (20*d - 12*v0*T - 3*a0*T2) / (2*T3);
+    c[4] = (-30*d + 16*v0*T + 3*a0*T2) / (2*T3*T);
+    c[5] = (12*d - 6*v0*T - a0*T2) / (2*T3*T2);
+}
+
+/* minimum-jerk velocity ramp v_a -> v_b in time T: distance, velocity and acceleration at t. */
+static void ramp(double v_a, double v_b, double T, double t, double& s, double& v, double& a)
+{
+    if(T <= 0.0)
+    {
+        s = 0.0;
+        v = v_b;
+        a = 0.0;
+        return;
+    }
+    double k = t / T;
+    double k2 = k*k;
+    double dv = v_b - v_a;
+    s = v_a*t + dv*T*k2*k2*(2.5 - 3*k + k2);
+    v = v_a + dv*k2*k*(10 - 15*k + 6*k2);
+    a = dv/T*k2*(30 - 60*k + 30*k2);
+}
+
+static double norm(const double v[3])
+{
+    return sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+}
+
+MinJerkTrajectory::MinJerkTrajectory()
+{
+    reset(geometry_msgs::Point());
+}
+
+void MinJerkTrajectory::reset(const geometry_msgs::Point& position)
+{
+    origin_[0] = position.x;
+    origin_[1] = position.y;
+    origin_[2] = position.z;
+    for(int i = 0; i < 3; ++i)
+    {
+        direction_[i] = 0.0;
+        for(int k = 0; k < 6; ++k)
+        {
+            coeff_[i][k] = 0.0;
+        }
+    }
+    v_start_ = v_cruise_ = 0.0;
+    t_accel_ = t_cruise_ = t_decel_ = 0.0;
+    s_accel_ = s_cruise_ = 0.0;
+    t_correction_ = 0.0;
+    duration_ = 0.0;
+    target_ = position;
+}
+
+void MinJerkTrajectory::plan(const TrajectoryState& from, const geometry_msgs::Point& target, const TrajectoryLimits& limits)
+{
+    const double p0[3] = {from.position.x, from.position.y, from.position.z};
+    const double v0[3] = {from.velocity.x, from.velocity.y, from.velocity.z};
+    const double a0[3] = {from.acceleration.x, from.acceleration.y, from.acceleration.z};
+    const double d[3] = {target.x - p0[0], target.y - p0[1], target.z - p0[2]};
+    const double a_max = limits.max_acceleration;
+
+    double distance = norm(d);
+    if(distance < 1e-6)
+    {
+        plan_quintic(from, target, limits);
+        return;
+    }
+
+    /* speed along the line: kept, the rest is decayed by the correction. */
+    double dir[3] = {d[0]/distance, d[1]/distance, d[2]/distance};
+    double v_start = fmax(0.0, v0[0]*dir[0] + v0[1]*dir[1] + v0[2]*dir[2]);
+    if(MIN_JERK_PEAK * v_start*v_start / (2*a_max) > distance)
+    {
+        plan_quintic(from, target, limits);     /* cannot stop at the target. */
+        return;
+    }
+
+    /* ramp v_start -> v_cruise, cruise, ramp v_cruise -> 0; each ramp covers
+     * MIN_JERK_PEAK*|v1^2 - v2^2|/(2*a_max). */
+    double v_cruise = sqrt((2*a_max*distance/MIN_JERK_PEAK + v_start*v_start) / 2);
+    v_cruise = fmin(v_cruise, limits.max_velocity);
+
+    t_accel_ = MIN_JERK_PEAK * fabs(v_cruise - v_start) / a_max;
+    t_decel_ = MIN_JERK_PEAK * v_cruise / a_max;
+    s_accel_ = 0.5 * (v_start + v_cruise) * t_accel_;
+    s_cruise_ = fmax(0.0, distance - s_accel_ - 0.5*v_cruise*t_decel_);
+    t_cruise_ = s_cruise_ / v_cruise;
+    v_start_ = v_start;
+    v_cruise_ = v_cruise;
+
+    /* correction: initial velocity across the line and initial acceleration -> 0.
+     * peak acceleration of the correction is about 4*|v|/T. */
+    double ev[3];
+    for(int i = 0; i < 3; ++i)
+    {
+        origin_[i] = p0[i];
+        direction_[i] = dir[i];
+        ev[i] = v0[i] - v_start*dir[i];
+    }
+    t_correction_ = fmax(limits.min_duration, 4*norm(ev) / a_max);
+    for(int i = 0; i < 3; ++i)
+    {
+        quintic(0.0, ev[i], a0[i], 0.0, t_correction_, coeff_[i]);
+    }
+
+    duration_ = fmax(t_accel_ + t_cruise_ + t_decel_, t_correction_);
+    target_ = target;
+}
+
+void MinJerkTrajectory::plan_quintic(const TrajectoryState& from, const geometry_msgs::Point& target, const TrajectoryLimits& limits)
+{
+    const double p0[3] = {from.position.x, from.position.y, from.position.z};
+    const double v0[3] = {from.velocity.x, from.velocity.y, from.velocity.z};
+    const double a0[3] = {from.acceleration.x, from.acceleration.y, from.acceleration.z};
+    const double p1[3] = {target.x, target.y, target.z};
+    const double d[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+
+    /* no line: the quintic is the whole trajectory. */
+    reset(geometry_msgs::Point());
+
+    /* rest to rest: peak velocity 1.875*D/T, peak acceleration 5.774*D/T^2. */
+    double distance = norm(d);
+    double T = limits.min_duration;
+    T = fmax(T, MIN_JERK_PEAK*distance / limits.max_velocity);
+    T = fmax(T, sqrt(5.774*distance / limits.max_acceleration));
+
+    /* already moving faster than allowed: only ask for no speed-up. */
+    double v_max = fmax(limits.max_velocity, norm(v0));
+    for(int stretch = 0; ; ++stretch)
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            quintic(p0[i], v0[i], a0[i], p1[i], T, coeff_[i]);
+        }
+        t_correction_ = T;
+        duration_ = T;
+        if(stretch == TRAJECTORY_STRETCH_MAX)
+        {
+            break;
+        }
+        bool within = true;
+        for(int n = 1; n <= TRAJECTORY_CHECK_SAMPLES && within; ++n)
+        {
+            TrajectoryState s = sample(T * n / TRAJECTORY_CHECK_SAMPLES);
+            const double v[3] = {s.velocity.x, s.velocity.y, s.velocity.z};
+            const double a[3] = {s.acceleration.x, s.acceleration.y, s.acceleration.z};
+            within = norm(v) <= v_max * 1.001 && norm(a) <= limits.max_acceleration * 1.001;
+        }
+        if(within)
+        {
+            break;
+        }
+        T *= TRAJECTORY_STRETCH;
+    }
+    target_ = target;
+}
+
+void MinJerkTrajectory::line_sample(double t, double& s, double& v, double& a) const
+{
+    if(t < t_accel_)
+    {
+        ramp(v_start_, v_cruise_, t_accel_, t, s, v, a);
+        return;
+    }
+    t -= t_accel_;
+    if(t < t_cruise_)
+    {
+        s = s_accel_ + v_cruise_*t;
+        v = v_cruise_;
+        a = 0.0;
+        return;
+    }
+    t = fmin(t - t_cruise_, t_decel_);
+    ramp(v_cruise_, 0.0, t_decel_, t, s, v, a);
+    s += s_accel_ + s_cruise_;
+}
+
+TrajectoryState MinJerkTrajectory::sample(double t) const
+{
+    t = fmax(0.0, fmin(t, duration_));
+    double s, ds, dds;
+    line_sample(t, s, ds, dds);
+
+    double tc = fmin(t, t_correction_);
+    double p[3], v[3], a[3];
+    for(int i = 0; i < 3; ++i)
+    {
+        const double* c = coeff_[i];
+        p[i] = origin_[i] + direction_[i]*s + c[0] + tc*(c[1] + tc*(c[2] + tc*(c[3] + tc*(c[4] + tc*c[5]))));
+        v[i] = direction_[i]*ds + c[1] + tc*(2*c[2] + tc*(3*c[3] + tc*(4*c[4] + tc*5*c[5])));
+        a[i] = direction_[i]*dds + 2*c[2] + tc*(6*c[3] + tc*(12*c[4] + tc*20*c[5]));
+    }
+    TrajectoryState state;
+    state.position.x = p[0];
+    state.position.y = p[1];
+    state.position.z = p[2];
+    state.velocity.x = v[0];
+    state.velocity.y = v[1];
+    state.velocity.z = v[2];
+    state.acceleration.x = a[0];
+    state.acceleration.y = a[1];
+    state.acceleration.z = a[2];
+    return state;
+}
@@ -0,0 +1,61 @@
+/**
+* @file     : vehicle_state.cpp
+* @brief    : vehicle state(mavros/state) with the flight mode interned to an enum on arrival.
+* @author   : libn
+* @time     : Oct 18, 2026
+*/
+
+#include <state_machine/vehicle_state.h>
+
+#include <string.h>
+
+/* indexed by FlightMode. */
+static const char* const flight_mode_names[] =
+{
+    "UNKNOWN",
+    "MANUAL",
+    "ACRO",
+    "ALTCTL",
+    "POSCTL",
+    "OFFBOARD",
+    "STABILIZED",
+    "RATTITUDE",
+    "AUTO.MISSION",
+    "AUTO.LOITER",
+    "AUTO.RTL",
+    "AUTO.LAND",
+    "AUTO.RTGS",
+    "AUTO.READY",
+    "AUTO.TAKEOFF",
+};
+
+static const int flight_mode_count = sizeof(flight_mode_names) / sizeof(flight_mode_names[0]);
+
+FlightMode flight_mode_from_string(const std::string& mode)
+{
+    for(int i = 1; i < flight_mode_count; ++i)
+    {
+        if(strcmp(mode.c_str(), flight_mode_names[i]) == 0)
+        {
+            return (FlightMode)i;
+        }
+    }
+    return MODE_UNKNOWN;
+}
+
+const char* flight_mode_name(FlightMode mode)
+{
+    if(mode < 0 || mode >= flight_mode_count)
+    {
+        return flight_mode_names[MODE_UNKNOWN];
+    }
+    return flight_mode_names[mode];
+}
+
+void vehicle_state_update(VehicleState& state, const state_machine::State& msg)
+{
+    state.connected = msg.connected;
+    state.armed = msg.armed;
+    state.guided = msg.guided;
+    state.mode = flight_mode_from_string(msg.mode);
+}